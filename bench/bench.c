@@ -0,0 +1,539 @@
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+
+#include "mahler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Times the public functions on randomized input, printing JSON //
+/*
+    {
+      "samples": 1000,
+      "calls_per_sample": 1024,
+      "benchmarks": [
+        { "name": "mah_get_inter", "ns_per_op": 12.41, "ops_per_sec": 80580177, "p50_ns": 12.30, ... },
+        ...
+      ]
+    }
+
+    Build with optimizations (make bench) for meaningful numbers.
+    Each sample times one pass over the input pool, percentiles are of ns/op across samples.
+*/
+
+#define BENCH_INPUTS 1024  // size of randomized input pool (power of 2), calls per sample
+#define BENCH_SAMPLES 1000 // samples timed per function
+#define BENCH_WARMUP 20    // untimed samples before timing
+#define BENCH_BUF 32       // note buffer size for chords and scales
+
+// Times statement (which may use input index n) and prints its JSON entry
+#define BENCH(name, ...)                                                                                              \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        for (int s = -BENCH_WARMUP; s < BENCH_SAMPLES; s++)                                                            \
+        {                                                                                                              \
+            double start = now_ns();                                                                                   \
+            for (int n = 0; n < BENCH_INPUTS; n++)                                                                     \
+            {                                                                                                          \
+                __VA_ARGS__;                                                                                           \
+            }                                                                                                          \
+            if (s >= 0)                                                                                                \
+            {                                                                                                          \
+                samples[s] = (now_ns() - start) / BENCH_INPUTS;                                                        \
+            }                                                                                                          \
+        }                                                                                                              \
+        report(name, samples, &first);                                                                                 \
+    } while (0)
+
+static int sink; // keeps results alive
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int
+compare_double(void const* a, void const* b)
+{
+    double diff = *(double const*) a - *(double const*) b;
+    return (diff > 0) - (diff < 0);
+}
+
+static void
+report(char const* name, double samples[], int* first)
+{
+    double total = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        total += samples[i];
+    }
+    qsort(samples, BENCH_SAMPLES, sizeof(*samples), compare_double);
+
+    double mean = total / BENCH_SAMPLES;
+    printf(
+        "%s    { \"name\": \"%s\", \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f, \"p50_ns\": %.2f, \"p90_ns\": %.2f, "
+        "\"p99_ns\": %.2f }",
+        *first ? "" : ",\n", name, mean, 1e9 / mean, samples[BENCH_SAMPLES / 2], samples[BENCH_SAMPLES * 9 / 10],
+        samples[BENCH_SAMPLES * 99 / 100]
+    );
+    *first = 0;
+}
+
+static struct mah_note
+random_note(void)
+{
+    return (struct mah_note) { rand() % 7, rand() % 3 - 1, rand() % 8 };
+}
+
+static enum mah_dur
+random_dur(void)
+{
+    static enum mah_dur const pool[] = {
+        MAH_WHOLE,        MAH_DOTTED_HALF, MAH_HALF,      MAH_DOTTED_QUARTER, MAH_QUARTER,
+        MAH_DOTTED_EIGHTH, MAH_EIGHTH,     MAH_SIXTEENTH, MAH_THIRTYSECOND,
+    };
+    return pool[rand() % (sizeof(pool) / sizeof(*pool))];
+}
+
+static void
+sink_midi_notes(struct mah_midi_note const notes[], int const num, void* ctx)
+{
+    (void) ctx;
+    sink += notes[num - 1].velocity;
+}
+
+int
+main(void)
+{
+    static struct mah_interval const inter_pool[] = {
+        { 1, MAH_PERFECT }, { 2, MAH_MINOR },     { 2, MAH_MAJOR },      { 3, MAH_MINOR },   { 3, MAH_MAJOR },
+        { 4, MAH_PERFECT }, { 4, MAH_AUGMENTED }, { 5, MAH_DIMINISHED }, { 5, MAH_PERFECT }, { 6, MAH_MINOR },
+        { 6, MAH_MAJOR },   { 7, MAH_MINOR },     { 7, MAH_MAJOR },      { 8, MAH_PERFECT }, { 10, MAH_MAJOR },
+    };
+    static struct mah_chord_base const* const chord_pool[] = {
+        &MAH_MAJOR_TRIAD, &MAH_MINOR_TRIAD, &MAH_AUGMENTED_TRIAD,   &MAH_DIMINISHED_TRIAD, &MAH_DIMINISHED_7,
+        &MAH_MAJOR_7,     &MAH_MINOR_7,     &MAH_HALF_DIMINISHED_7, &MAH_DOMINANT_7,
+    };
+    static struct mah_scale_base const* const scale_pool[] = {
+        &MAH_MAJOR_SCALE,         &MAH_NATURAL_MIN_SCALE,    &MAH_HARMONIC_MIN_SCALE,    &MAH_MELODIC_MIN_SCALE,
+        &MAH_PENTATONIC_MAJ_SCALE, &MAH_PENTATONIC_MIN_SCALE, &MAH_BLUES_SCALE,           &MAH_WHOLE_TONE_SCALE,
+        &MAH_OCTATONIC_HALF_SCALE, &MAH_OCTATONIC_WHOLE_SCALE,
+    };
+    static struct mah_tuplet const triplet = { 3, 2, MAH_EIGHTH };
+
+    static struct mah_note notes_a[BENCH_INPUTS];
+    static struct mah_note notes_b[BENCH_INPUTS];
+    static struct mah_interval inters[BENCH_INPUTS];
+    static struct mah_chord_base const* chords[BENCH_INPUTS];
+    static struct mah_scale_base const* scales[BENCH_INPUTS];
+    static struct mah_note chord_notes[BENCH_INPUTS][BENCH_BUF];
+    static struct mah_note scale_notes[BENCH_INPUTS][BENCH_BUF];
+    static struct mah_timed_note timed[BENCH_INPUTS];
+    static struct mah_timed_note measures[BENCH_INPUTS][32];
+    static int measure_sizes[BENCH_INPUTS];
+    static int sizes[BENCH_INPUTS];
+    static char symbols[BENCH_INPUTS][16];
+    static size_t symbol_lens[BENCH_INPUTS];
+    static double samples[BENCH_SAMPLES];
+
+    srand(1);
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        notes_a[i]        = random_note();
+        notes_b[i]        = random_note();
+        notes_b[i].octave = notes_a[i].octave + 1; // keep note_b above note_a
+        inters[i]         = inter_pool[rand() % (sizeof(inter_pool) / sizeof(*inter_pool))];
+        chords[i]         = chord_pool[rand() % (sizeof(chord_pool) / sizeof(*chord_pool))];
+        scales[i]         = scale_pool[rand() % (sizeof(scale_pool) / sizeof(*scale_pool))];
+        sizes[i]          = 2 + rand() % 4;
+
+        // chords and scales of random notes, as recognized from played notes
+        mah_get_chord(random_note(), chords[i], (struct mah_note[BENCH_BUF]) { 0 }, chord_notes[i], NULL);
+        mah_get_scale(random_note(), &MAH_MAJOR_SCALE, scale_notes[i], MAH_ASCEND, NULL);
+        mah_write_chord_symbol((struct mah_chord_result) { notes_a[i], chords[i] }, symbols[i], 16, NULL);
+        symbol_lens[i] = strlen(symbols[i]);
+
+        timed[i] = (struct mah_timed_note) { notes_a[i].tone, notes_a[i].acci, notes_a[i].octave, random_dur(), NULL };
+        if (rand() % 8 == 0)
+        {
+            timed[i].duration = MAH_TUPLET;
+            timed[i].tuplet   = (struct mah_tuplet*) &triplet;
+        }
+
+        // 4/4 measure filled with random durations (all multiples of a thirtysecond, so it always completes)
+        int ticks = 0;
+        int size  = 0;
+        while (ticks < 1920)
+        {
+            struct mah_timed_note note = { MAH_C, 0, 4, random_dur(), NULL };
+            int dur                    = mah_get_duration_ticks(&note, &(enum mah_error) { 0 });
+            if (ticks + dur > 1920)
+            {
+                continue;
+            }
+            measures[i][size++] = note;
+            ticks += dur;
+        }
+        measure_sizes[i] = size;
+    }
+
+    static enum mah_tone tone[BENCH_INPUTS], tone_b[BENCH_INPUTS], out_tone[BENCH_INPUTS];
+    static int acci[BENCH_INPUTS], acci_b[BENCH_INPUTS], out_acci[BENCH_INPUTS];
+    static enum mah_octave octave[BENCH_INPUTS], octave_b[BENCH_INPUTS], out_octave[BENCH_INPUTS];
+    static bool enharmonic[BENCH_INPUTS];
+    static struct mah_interval out_inters[BENCH_INPUTS];
+    static mah_note16 packed[BENCH_INPUTS];
+    static char text[BENCH_INPUTS * MAH_DISP_LEN];
+    static int text_offsets[BENCH_INPUTS + 1];
+    static struct mah_note notes_out[BENCH_INPUTS];
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        tone[i]     = notes_a[i].tone;
+        acci[i]     = notes_a[i].acci;
+        octave[i]   = notes_a[i].octave;
+        tone_b[i]   = notes_b[i].tone;
+        acci_b[i]   = notes_b[i].acci;
+        octave_b[i] = notes_b[i].octave;
+    }
+    struct mah_note_batch batch   = { tone, acci, octave, BENCH_INPUTS };
+    struct mah_note_batch batch_b = { tone_b, acci_b, octave_b, BENCH_INPUTS };
+    struct mah_note_batch out     = { out_tone, out_acci, out_octave, 0 };
+
+    static struct mah_chord_index_entry chord_entries[768];
+    static struct mah_chord_index chord_index = { .max = 768, .entries = chord_entries };
+    mah_get_chord_index(&chord_index, NULL, NULL);
+    static uint64_t scale_bits[MAH_SCALE_INDEX_WORDS(4)];
+    struct mah_scale_index scale_index = { NULL, 0, 0, MAH_SCALE_INDEX_WORDS(4), scale_bits };
+    mah_get_scale_index(&scale_index, NULL, NULL);
+
+    static struct mah_note chord_batch_notes[BENCH_INPUTS * 4], scale_batch_notes[BENCH_INPUTS * 7];
+    static int chord_offsets[BENCH_INPUTS + 1], scale_offsets[BENCH_INPUTS + 1];
+    static struct mah_chord_result chord_batch_results[BENCH_INPUTS][BENCH_BUF];
+    static struct mah_scale_result scale_batch_results[BENCH_INPUTS][BENCH_BUF];
+    static struct mah_chord_result_list chord_lists[BENCH_INPUTS];
+    static struct mah_scale_result_list scale_lists[BENCH_INPUTS];
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    { // queries packed back to back
+        chord_offsets[i + 1] = chord_offsets[i] + chords[i]->size;
+        scale_offsets[i + 1] = scale_offsets[i] + 7;
+        memcpy(chord_batch_notes + chord_offsets[i], chord_notes[i], sizeof(struct mah_note) * chords[i]->size);
+        memcpy(scale_batch_notes + scale_offsets[i], scale_notes[i], sizeof(struct mah_note) * 7);
+    }
+
+    struct mah_key_sig key = mah_return_key_sig(3, MAH_MAJOR_KEY);
+    static struct mah_note spelled[BENCH_INPUTS];
+    static int bars[BENCH_INPUTS / 8];
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        spelled[i] = notes_a[i];
+    }
+    for (int i = 0; i < BENCH_INPUTS / 8; i++)
+    { // measures of 8 notes
+        bars[i] = (i + 1) * 8;
+    }
+    mah_write_notes(notes_a, BENCH_INPUTS, text, sizeof(text), ",", text_offsets, NULL);
+
+    // single track of random keys, note on then note off with running status
+    static unsigned char midi[14 + 8 + BENCH_INPUTS * 7 + 4] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96 };
+    static struct mah_midi_note midi_notes[64];
+    size_t midi_len         = sizeof(midi) - 14 - 8;
+    unsigned char* midi_pos = midi + 14;
+    memcpy(midi_pos, (unsigned char[]) { 'M', 'T', 'r', 'k', 0, 0, midi_len >> 8, midi_len & 0xFF }, 8);
+    midi_pos += 8;
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        int midi_key = 36 + rand() % 48;
+        memcpy(midi_pos, (unsigned char[]) { 0x00, 0x90, midi_key, 1 + rand() % 127, 0x60, midi_key, 0 }, 7);
+        midi_pos += 7;
+    }
+    memcpy(midi_pos, (unsigned char[]) { 0x00, 0xFF, 0x2F, 0x00 }, 4);
+    struct mah_midi_file midi_file = mah_read_midi_file(midi, sizeof(midi), NULL);
+    static unsigned char midi_out_data[sizeof(midi) * 2];
+    struct mah_midi_track midi_track = { timed, BENCH_INPUTS, 0, 100 };
+    struct mah_buffer midi_out       = { sizeof(midi_out_data), 0, midi_out_data, NULL };
+
+    // pieces of 8 notes
+    static size_t piece_offsets[BENCH_INPUTS / 8 + 1];
+    static uint64_t corpus_words[BENCH_INPUTS * 4 + 256];
+    for (int i = 0; i <= BENCH_INPUTS / 8; i++)
+    {
+        piece_offsets[i] = (size_t) i * 8;
+    }
+    struct mah_tuplet_table corpus_table = { 1, 0, (struct mah_tuplet[1]) { { 0 } } };
+    struct mah_buffer corpus_out         = { sizeof(corpus_words), 0, (unsigned char*) corpus_words, NULL };
+    mah_write_corpus(timed, piece_offsets, BENCH_INPUTS / 8, &corpus_table, &corpus_out, NULL);
+    struct mah_corpus corpus = mah_read_corpus(corpus_out.data, corpus_out.size, NULL);
+
+    static unsigned char stream_bytes[BENCH_INPUTS * MAH_NOTE_STREAM_MAX];
+    static struct mah_timed_note stream_notes[BENCH_INPUTS];
+    struct mah_note_stream stream = { 0 };
+    size_t stream_len             = 0;
+    mah_encode_notes(&stream, timed, BENCH_INPUTS, stream_bytes, sizeof(stream_bytes), &stream_len, &corpus_table, NULL);
+
+    static uint64_t starts[BENCH_INPUTS];
+    uint64_t timeline_ticks[1];
+    struct mah_timeline timeline = { .tuplets = &corpus_table, .tuplet_ticks = timeline_ticks };
+    mah_get_timeline(&timeline, timed, BENCH_INPUTS, NULL);
+
+    // the 4/4 measures back to back, as one stream or as one score each
+    static struct mah_timed_note measure_notes[BENCH_INPUTS * 32];
+    static size_t measure_offsets[BENCH_INPUTS + 1];
+    static int measure_change_offsets[BENCH_INPUTS + 1];
+    static struct mah_time_change measure_changes[BENCH_INPUTS];
+    static struct mah_measure_list measure_lists[BENCH_INPUTS];
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        measure_offsets[i + 1]        = measure_offsets[i] + (size_t) measure_sizes[i];
+        measure_change_offsets[i + 1] = i + 1;
+        measure_changes[i]            = (struct mah_time_change) { 0, { 4, 4 } };
+        memcpy(measure_notes + measure_offsets[i], measures[i], sizeof(struct mah_timed_note) * measure_sizes[i]);
+    }
+    static struct mah_tied_note tied[BENCH_INPUTS * 8];
+    struct mah_timeline measure_timeline = { 0 };
+    mah_get_timeline(&measure_timeline, measure_notes, (int) measure_offsets[BENCH_INPUTS], NULL);
+
+    // the measures played at 120 bpm, with onsets and offsets jittered by up to 15 ms
+    static struct mah_quant_table quant_table;
+    static struct mah_played_note played[BENCH_INPUTS];
+    static struct mah_timed_note quantized[BENCH_INPUTS * 4];
+    static unsigned char quant_buf[BENCH_INPUTS * 64];
+    struct mah_tuplet quant_triplet = { 3, 2, MAH_EIGHTH };
+    struct mah_quant_config quant   = { 12, 2, &quant_triplet, 1, 1, 0.2, 0.5, 0.5, 1 };
+    struct mah_arena quant_arena    = { sizeof(quant_buf), 0, quant_buf };
+    double seconds                  = 0;
+    mah_get_quant_table(&quant_table, &quant, NULL);
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        double length = mah_get_duration_ticks(&measure_notes[i], &(enum mah_error) { 0 }) / 960.0;
+        double onset  = seconds + (rand() % 31 - 15) / 1000.0;
+        played[i]     = (struct mah_played_note) { notes_a[i], onset < 0 ? 0 : onset, onset + length * 0.9 };
+        seconds += length;
+    }
+
+    // a tempo change every measure, with random ticks for single lookups and eighths for batches
+    static struct mah_tempo_change tempo_changes[BENCH_INPUTS / 4];
+    static struct mah_tempo_point tempo_points[BENCH_INPUTS / 4];
+    static uint64_t tempo_ticks[BENCH_INPUTS];
+    static uint64_t tempo_sorted[BENCH_INPUTS];
+    static double tempo_seconds[BENCH_INPUTS];
+    static double tempo_sorted_seconds[BENCH_INPUTS];
+    static uint64_t tempo_back[BENCH_INPUTS];
+    struct mah_tempo_map tempo_map = { tempo_points, 0 };
+    for (int i = 0; i < BENCH_INPUTS / 4; i++)
+    {
+        tempo_changes[i] = (struct mah_tempo_change) { (uint64_t) i * 1920, 60 + rand() % 121 };
+    }
+    mah_get_tempo_map(&tempo_map, tempo_changes, BENCH_INPUTS / 4, NULL);
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        tempo_ticks[i]  = (uint64_t) (rand() % (BENCH_INPUTS / 4 * 1920));
+        tempo_sorted[i] = (uint64_t) i * 240;
+    }
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        tempo_seconds[i] = mah_get_tempo_seconds(&tempo_map, tempo_ticks[i], NULL);
+    }
+    mah_get_tempo_seconds_batch(&tempo_map, tempo_sorted, BENCH_INPUTS, tempo_sorted_seconds, NULL);
+
+    struct mah_note base[BENCH_BUF], notes[BENCH_BUF];
+    struct mah_chord_result chord_results[BENCH_BUF];
+    struct mah_scale_result scale_results[BENCH_BUF];
+    char buf[MAH_DISP_LEN];
+    char symbol_buf[16];
+    int first = 1;
+
+    printf("{\n  \"samples\": %d,\n  \"calls_per_sample\": %d,\n  \"benchmarks\": [\n", BENCH_SAMPLES, BENCH_INPUTS);
+
+    // Intervals //
+
+    BENCH("mah_get_inter", sink += mah_get_inter(notes_a[n], inters[n], NULL).acci);
+    BENCH("mah_return_inter", sink += mah_return_inter(notes_a[n], notes_b[n], NULL).qual);
+
+    // Chords //
+
+    BENCH("mah_get_chord", sink += mah_get_chord(notes_a[n], chords[n], base, notes, NULL).size);
+    BENCH("mah_return_chord", {
+        struct mah_chord_result_list list = { BENCH_BUF, 0, chord_results };
+        mah_return_chord(chord_notes[n], chords[n]->size, &list, NULL, NULL);
+        sink += list.size;
+    });
+    BENCH("mah_return_chord_index", {
+        struct mah_chord_result_list list = { BENCH_BUF, 0, chord_results };
+        mah_return_chord_index(chord_notes[n], chords[n]->size, &list, &chord_index, NULL);
+        sink += list.size;
+    });
+
+    BENCH("mah_return_chord_batch", {
+        if (n == 0)
+        {
+            for (int i = 0; i < BENCH_INPUTS; i++)
+            {
+                chord_lists[i] = (struct mah_chord_result_list) { BENCH_BUF, 0, chord_batch_results[i] };
+            }
+            mah_return_chord_batch(chord_batch_notes, chord_offsets, BENCH_INPUTS, chord_lists, &chord_index, 0, NULL);
+        }
+    });
+
+    BENCH("mah_read_chord_symbol", sink += mah_read_chord_symbol(symbols[n], symbol_lens[n], NULL, NULL).key.acci);
+    BENCH("mah_write_chord_symbol", {
+        sink += mah_write_chord_symbol((struct mah_chord_result) { notes_a[n], chords[n] }, symbol_buf, 16, NULL)[0];
+    });
+
+    // Scales //
+
+    BENCH("mah_get_scale", sink += mah_get_scale(notes_a[n], scales[n], notes, MAH_ASCEND, NULL).size);
+    BENCH("mah_return_scale", {
+        struct mah_scale_result_list list = { BENCH_BUF, 0, scale_results };
+        mah_return_scale(scale_notes[n], 7, &list, NULL, NULL);
+        sink += list.size;
+    });
+    BENCH("mah_return_scale_index", {
+        struct mah_scale_result_list list = { BENCH_BUF, 0, scale_results };
+        mah_return_scale_index(scale_notes[n], 7, &list, &scale_index, NULL);
+        sink += list.size;
+    });
+
+    BENCH("mah_return_scale_batch", {
+        if (n == 0)
+        {
+            for (int i = 0; i < BENCH_INPUTS; i++)
+            {
+                scale_lists[i] = (struct mah_scale_result_list) { BENCH_BUF, 0, scale_batch_results[i] };
+            }
+            mah_return_scale_batch(scale_batch_notes, scale_offsets, BENCH_INPUTS, scale_lists, &scale_index, 0, NULL);
+        }
+    });
+
+    // Keys //
+
+    BENCH("mah_get_key_sig", sink += mah_get_key_sig(notes_a[n], n & 1).alter);
+    BENCH("mah_query_acci", sink += mah_query_acci(&key, notes_a[n].tone));
+
+    // Misc //
+
+    BENCH("mah_write_note", sink += mah_write_note(notes_a[n], buf, MAH_DISP_LEN, NULL)[0]);
+    BENCH("mah_read_note", sink += mah_read_note(text + text_offsets[n], MAH_DISP_LEN, NULL, NULL).acci);
+    BENCH("mah_read_corpus", sink += mah_read_corpus(corpus_out.data, corpus_out.size, NULL).pieces);
+    BENCH("mah_get_corpus_piece", sink += mah_get_corpus_piece(&corpus, n % (BENCH_INPUTS / 8), NULL).size);
+    BENCH("mah_is_enharmonic", sink += mah_is_enharmonic(notes_a[n], notes_b[n]));
+
+    // Rhythm //
+
+    BENCH("mah_get_duration_ticks", sink += mah_get_duration_ticks(timed + n, &(enum mah_error) { 0 }));
+    BENCH("mah_get_timeline_ticks", sink += (int) mah_get_timeline_ticks(&timeline, timed + n, NULL));
+    BENCH("mah_validate_measure", {
+        enum mah_error err = MAH_ERROR_NONE;
+        mah_validate_measure(measures[n], measure_sizes[n], (struct mah_time_sig) { 4, 4 }, &err);
+        sink += err;
+    });
+    BENCH("mah_segment_measures", {
+        if (n == 0)
+        {
+            struct mah_measure_list list     = { 0, 0, NULL, NULL };
+            struct mah_measure_stream stream = mah_start_measures(measure_changes, 1, NULL);
+            mah_segment_measures(&stream, measure_notes, (int) measure_offsets[BENCH_INPUTS], &list, NULL);
+            sink += list.size;
+        }
+    });
+    BENCH("mah_validate_measure_batch", {
+        if (n == 0)
+        {
+            mah_validate_measure_batch(
+                measure_notes, measure_offsets, BENCH_INPUTS, measure_changes, measure_change_offsets, measure_lists, 0,
+                NULL
+            );
+        }
+    });
+    BENCH("mah_get_tempo_seconds", sink += (int) mah_get_tempo_seconds(&tempo_map, tempo_ticks[n], NULL));
+    BENCH("mah_get_tempo_tick", sink += (int) mah_get_tempo_tick(&tempo_map, tempo_seconds[n], NULL));
+
+    // Nontertian //
+
+    BENCH("mah_get_quartal_chord", sink += mah_get_quartal_chord(notes_a[n], sizes[n], base, notes, NULL).size);
+    BENCH("mah_get_quintal_chord", sink += mah_get_quintal_chord(notes_a[n], sizes[n], base, notes, NULL).size);
+
+    // Batch, per note //
+
+    BENCH("mah_get_inter_batch", if (n == 0) mah_get_inter_batch(&batch, inters[0], &out, NULL));
+    BENCH("mah_return_inter_batch", if (n == 0) mah_return_inter_batch(&batch, &batch_b, out_inters, NULL));
+    BENCH("mah_is_enharmonic_batch", if (n == 0) mah_is_enharmonic_batch(&batch, &batch_b, enharmonic));
+    BENCH("mah_pack_notes", if (n == 0) mah_pack_notes(notes_a, packed, BENCH_INPUTS, NULL));
+    BENCH("mah_write_notes", {
+        if (n == 0)
+        {
+            mah_write_notes(notes_a, BENCH_INPUTS, text, sizeof(text), ",", text_offsets, NULL);
+        }
+    });
+    BENCH("mah_read_notes", if (n == 0) mah_read_notes(text, text_offsets[BENCH_INPUTS], notes_out, BENCH_INPUTS, NULL, NULL));
+    BENCH("mah_read_midi_notes", if (n == 0) mah_read_midi_notes(&midi_file, midi_notes, 64, sink_midi_notes, NULL, NULL));
+    BENCH("mah_write_midi_file", if (n == 0) mah_write_midi_file(&midi_track, 1, &midi_out, NULL));
+    BENCH("mah_get_timeline_starts", if (n == 0) mah_get_timeline_starts(&timeline, timed, BENCH_INPUTS, 0, starts, NULL));
+    BENCH("mah_quantize_notes", {
+        if (n == 0)
+        {
+            sink += mah_quantize_notes(
+                played, BENCH_INPUTS, 120, &quant_table, &quant_arena, quantized, BENCH_INPUTS * 4, NULL
+            );
+        }
+    });
+    BENCH("mah_get_tempo_seconds_batch", {
+        if (n == 0)
+        {
+            mah_get_tempo_seconds_batch(&tempo_map, tempo_sorted, BENCH_INPUTS, tempo_sorted_seconds, NULL);
+        }
+    });
+    BENCH("mah_get_tempo_ticks_batch", {
+        if (n == 0)
+        {
+            mah_get_tempo_ticks_batch(&tempo_map, tempo_sorted_seconds, BENCH_INPUTS, tempo_back, NULL);
+        }
+    });
+    BENCH("mah_split_notes", {
+        if (n == 0)
+        { // split at every beat of the 4/4 measures
+            struct mah_time_sig time_sig = { 4, 4 };
+            struct mah_tied_list list    = { BENCH_INPUTS * 8, 0, tied, NULL };
+            struct mah_tie_stream stream = mah_start_ties(&measure_timeline, time_sig, true, NULL, NULL);
+            mah_split_notes(&stream, measure_notes, BENCH_INPUTS, &list, NULL);
+            sink += list.size;
+        }
+    });
+    BENCH("mah_encode_notes", {
+        if (n == 0)
+        {
+            stream = (struct mah_note_stream) { 0 };
+            mah_encode_notes(&stream, timed, BENCH_INPUTS, stream_bytes, sizeof(stream_bytes), NULL, &corpus_table, NULL);
+        }
+    });
+    BENCH("mah_decode_notes", {
+        if (n == 0)
+        {
+            stream = (struct mah_note_stream) { 0 };
+            mah_decode_notes(&stream, stream_bytes, stream_len, NULL, stream_notes, BENCH_INPUTS, &corpus_table, NULL);
+        }
+    });
+    BENCH("mah_write_corpus", {
+        if (n == 0)
+        {
+            mah_write_corpus(timed, piece_offsets, BENCH_INPUTS / 8, &corpus_table, &corpus_out, NULL);
+        }
+    });
+    BENCH("mah_apply_key_sig_notes", {
+        if (n == 0)
+        {
+            mah_apply_key_sig_notes(spelled, BENCH_INPUTS, bars, BENCH_INPUTS / 8, &key, NULL);
+        }
+    });
+    BENCH("mah_strip_key_sig_notes", {
+        if (n == 0)
+        {
+            mah_strip_key_sig_notes(spelled, BENCH_INPUTS, bars, BENCH_INPUTS / 8, &key, NULL);
+        }
+    });
+
+    printf("\n  ]\n}\n");
+    return sink == 42;
+}
@@ -9,6 +9,7 @@
 
 #include "err/err.h"
 #include "note/note.h"
+#include "arena/arena.h"
 #include "inter/inter.h"
 #include "scale/scale.h"
 #include "chord/chord.h"
@@ -17,5 +18,11 @@
 #include "rhythm/rhythm.h"
 #include "nontertian/quartal.h"
 #include "nontertian/quintal.h"
+#include "pack/pack.h"
+#include "midi/midi.h"
+#include "corpus/corpus.h"
+#include "timeline/timeline.h"
+#include "quant/quant.h"
+#include "stats/stats.h"
 
 #endif
\ No newline at end of file
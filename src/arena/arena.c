@@ -0,0 +1,70 @@
+/*
+
+| arena.c |
+Defines the bump allocator used by growable result lists
+All memory comes from a caller supplied buffer, nothing is freed until reset
+
+*/
+
+#include "arena/arena.h"
+#include "shared/shared.h"
+#include <stdint.h>
+#include <string.h>
+
+// Internal Functions //
+
+void*
+grow_results(void* results, int* max, size_t const elem, struct mah_arena* arena)
+{ // returns results with room for at least one more element, or NULL if it can not grow
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    int grow           = *max > 0 ? *max : RESULTS_GROW_MIN;
+    unsigned char* end = (unsigned char*) results + (size_t) *max * elem;
+    if (results != NULL && end == arena->buf + arena->used && arena->size - arena->used >= (size_t) grow * elem)
+    { // last allocation of the arena, extend in place
+        arena->used += (size_t) grow * elem;
+        *max += grow;
+        return results;
+    }
+
+    void* grown = mah_arena_alloc(arena, (size_t) (*max + grow) * elem, sizeof(void*), NULL);
+    if (grown == NULL)
+    {
+        return NULL;
+    }
+    if (*max > 0)
+    {
+        memcpy(grown, results, (size_t) *max * elem);
+    }
+    *max += grow;
+    return grown;
+}
+
+// Functions //
+
+void*
+mah_arena_alloc(struct mah_arena* arena, size_t const size, size_t const align, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_ARENA_ALLOC);
+
+    uintptr_t addr = (uintptr_t) (arena->buf + arena->used);
+    size_t padding = align > 1 ? (align - addr % align) % align : 0;
+    if (arena->used + padding > arena->size || size > arena->size - arena->used - padding)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_ARENA);
+        return NULL;
+    }
+
+    void* ptr = arena->buf + arena->used + padding;
+    arena->used += padding + size;
+    return ptr;
+}
+
+void
+mah_arena_reset(struct mah_arena* arena)
+{
+    arena->used = 0;
+}
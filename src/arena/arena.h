@@ -0,0 +1,29 @@
+#ifndef __MAH_ARENA_H__
+#define __MAH_ARENA_H__
+
+#include "err/err.h"
+#include <stddef.h>
+
+// Structures //
+
+typedef struct mah_arena
+{
+    size_t size;        // bytes in buf
+    size_t used;        // bytes allocated so far
+    unsigned char* buf; // caller supplied memory
+} mah_arena;
+
+typedef struct mah_buffer
+{
+    size_t max;              // bytes in data
+    size_t size;             // bytes written (or needed, if too small)
+    unsigned char* data;     // written bytes
+    struct mah_arena* arena; // holds data when max is too small (optional)
+} mah_buffer;
+
+// Functions //
+
+void* mah_arena_alloc(struct mah_arena* arena, size_t size, size_t align, enum mah_error* err);
+void mah_arena_reset(struct mah_arena* arena);
+
+#endif
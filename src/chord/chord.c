@@ -7,6 +7,7 @@ Includes definition of preset chords
 */
 
 #include "chord/chord.h"
+#include "pool/pool.h"
 #include <string.h>
 
 // Preset Chords //
@@ -97,6 +98,199 @@ struct mah_chord_base const MAH_DOMINANT_7 = {
     },
 };
 
+// Macros //
+
+#define CHORD_BATCH_MIN 1024 // queries per thread of mah_return_chord_batch, fewer cost less than starting it
+
+#define SYMBOL_SEED 799u  // hash seed, chosen so no two suffixes of SYMBOL_TABLE share a slot (tested by reading each)
+#define SYMBOL_BITS 6     // log2 of SYMBOL_TABLE size
+#define SYMBOL_MAX 6      // longest suffix in bytes
+#define SYMBOL_TEXT_MAX 5 // root (1) + max acci (4), the suffix is added to this
+
+// One step of the suffix hash, over bytes
+#define SYMBOL_STEP(hash, c) ((((hash) ^ (unsigned char) (c)) * 31u) & 0xFFFFFFFFu)
+
+// Slot of a finished suffix hash (multiplicative hashing, top SYMBOL_BITS bits)
+#define SYMBOL_SLOT(hash) ((((hash) * 2654435761u) & 0xFFFFFFFFu) >> (32 - SYMBOL_BITS))
+
+// Suffix hashes by length, so SYMBOL_TABLE slots are computed at compile time
+#define SYMBOL_HASH0() SYMBOL_SEED
+#define SYMBOL_HASH1(a) SYMBOL_STEP(SYMBOL_HASH0(), a)
+#define SYMBOL_HASH2(a, b) SYMBOL_STEP(SYMBOL_HASH1(a), b)
+#define SYMBOL_HASH3(a, b, c) SYMBOL_STEP(SYMBOL_HASH2(a, b), c)
+#define SYMBOL_HASH4(a, b, c, d) SYMBOL_STEP(SYMBOL_HASH3(a, b, c), d)
+#define SYMBOL_HASH6(a, b, c, d, e, f) SYMBOL_STEP(SYMBOL_STEP(SYMBOL_HASH4(a, b, c, d), e), f)
+
+// Entry of SYMBOL_TABLE for suffix text, at the slot of hash
+#define SYMBOL_ENTRY(hash, text, chord) [SYMBOL_SLOT(hash)] = { text, sizeof(text) - 1, &chord }
+
+// Structures //
+
+struct chord_batch
+{ // shared by the workers of mah_return_chord_batch
+    struct mah_note const* notes;
+    int const* offsets;
+    struct mah_chord_result_list* lists;
+    struct mah_chord_index const* index;
+    struct pool_fail fails[MAH_THREADS_MAX];
+};
+
+struct chord_symbol
+{ // quality suffix of a chord symbol
+    char const* text;
+    int len;
+    struct mah_chord_base const* chord;
+};
+
+// Global Variables //
+
+static struct mah_chord_base const* CHORD_POS[] = {
+    // Default chord list for return functions
+    &MAH_MAJOR_TRIAD,      &MAH_MINOR_TRIAD,  &MAH_AUGMENTED_TRIAD,
+    &MAH_DIMINISHED_TRIAD, &MAH_DIMINISHED_7, &MAH_DOMINANT_7,
+};
+
+static struct chord_symbol const SYMBOL_TABLE[1 << SYMBOL_BITS] = {
+    // Perfect hash of every suffix read by mah_read_chord_symbol, empty slots have NULL chord
+    SYMBOL_ENTRY(SYMBOL_HASH0(), "", MAH_MAJOR_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH1('M'), "M", MAH_MAJOR_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH3('m', 'a', 'j'), "maj", MAH_MAJOR_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH1('m'), "m", MAH_MINOR_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH3('m', 'i', 'n'), "min", MAH_MINOR_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH1('-'), "-", MAH_MINOR_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH1('+'), "+", MAH_AUGMENTED_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH3('a', 'u', 'g'), "aug", MAH_AUGMENTED_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH1('o'), "o", MAH_DIMINISHED_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH3('d', 'i', 'm'), "dim", MAH_DIMINISHED_TRIAD),
+    SYMBOL_ENTRY(SYMBOL_HASH2('\xC2', '\xB0'), "\xC2\xB0", MAH_DIMINISHED_TRIAD), // degree sign
+    SYMBOL_ENTRY(SYMBOL_HASH2('o', '7'), "o7", MAH_DIMINISHED_7),
+    SYMBOL_ENTRY(SYMBOL_HASH4('d', 'i', 'm', '7'), "dim7", MAH_DIMINISHED_7),
+    SYMBOL_ENTRY(SYMBOL_HASH3('\xC2', '\xB0', '7'), "\xC2\xB0" "7", MAH_DIMINISHED_7),
+    SYMBOL_ENTRY(SYMBOL_HASH4('m', '7', 'b', '5'), "m7b5", MAH_HALF_DIMINISHED_7),
+    SYMBOL_ENTRY(SYMBOL_HASH6('m', 'i', 'n', '7', 'b', '5'), "min7b5", MAH_HALF_DIMINISHED_7),
+    SYMBOL_ENTRY(SYMBOL_HASH4('-', '7', 'b', '5'), "-7b5", MAH_HALF_DIMINISHED_7),
+    SYMBOL_ENTRY(SYMBOL_HASH2('\xC3', '\xB8'), "\xC3\xB8", MAH_HALF_DIMINISHED_7), // o with stroke
+    SYMBOL_ENTRY(SYMBOL_HASH3('\xC3', '\xB8', '7'), "\xC3\xB8" "7", MAH_HALF_DIMINISHED_7),
+    SYMBOL_ENTRY(SYMBOL_HASH2('m', '7'), "m7", MAH_MINOR_7),
+    SYMBOL_ENTRY(SYMBOL_HASH4('m', 'i', 'n', '7'), "min7", MAH_MINOR_7),
+    SYMBOL_ENTRY(SYMBOL_HASH2('-', '7'), "-7", MAH_MINOR_7),
+    SYMBOL_ENTRY(SYMBOL_HASH4('m', 'a', 'j', '7'), "maj7", MAH_MAJOR_7),
+    SYMBOL_ENTRY(SYMBOL_HASH2('M', '7'), "M7", MAH_MAJOR_7),
+    SYMBOL_ENTRY(SYMBOL_HASH2('\xCE', '\x94'), "\xCE\x94", MAH_MAJOR_7), // delta
+    SYMBOL_ENTRY(SYMBOL_HASH3('\xCE', '\x94', '7'), "\xCE\x94" "7", MAH_MAJOR_7),
+    SYMBOL_ENTRY(SYMBOL_HASH1('7'), "7", MAH_DOMINANT_7),
+};
+
+static struct chord_symbol const SYMBOL_WRITE[] = {
+    // Suffix written by mah_write_chord_symbol for each preset chord
+    { "", 0, &MAH_MAJOR_TRIAD },
+    { "m", 1, &MAH_MINOR_TRIAD },
+    { "aug", 3, &MAH_AUGMENTED_TRIAD },
+    { "dim", 3, &MAH_DIMINISHED_TRIAD },
+    { "dim7", 4, &MAH_DIMINISHED_7 },
+    { "m7b5", 4, &MAH_HALF_DIMINISHED_7 },
+    { "m7", 2, &MAH_MINOR_7 },
+    { "maj7", 4, &MAH_MAJOR_7 },
+    { "7", 1, &MAH_DOMINANT_7 },
+};
+
+// Internal Functions //
+
+static void
+return_chord_task(void* ctx, int const begin, int const end, int const worker)
+{ // each query only writes its own list, so results do not depend on the schedule
+    struct chord_batch* batch = ctx;
+    for (int q = begin; q < end; q++)
+    {
+        enum mah_error query_err = MAH_ERROR_NONE;
+        int first                = batch->offsets[q];
+        mah_return_chord_index(
+            batch->notes + first, batch->offsets[q + 1] - first, &batch->lists[q], batch->index, &query_err
+        );
+        pool_set_fail(&batch->fails[worker], q, query_err);
+    }
+}
+
+static enum mah_error
+chord_mask(struct mah_chord_base const* chord, mah_pitch_set* mask)
+{ // pitch class set of chord on C, walking the intervals like mah_get_chord without a note buffer
+    struct mah_note note = { .tone = MAH_C, .acci = MAH_NATURAL };
+    *mask                = to_pitch_set(&note, 1);
+    for (int i = 1; i < chord->size; i++)
+    {
+        enum mah_error inter_err = MAH_ERROR_NONE;
+
+        note = mah_get_inter(note, chord->steps[i - 1], &inter_err);
+        if (inter_err != MAH_ERROR_NONE)
+        {
+            return inter_err;
+        }
+        *mask |= to_pitch_set(&note, 1);
+    }
+    return MAH_ERROR_NONE;
+}
+
+static void
+return_chords(
+    struct mah_note const notes[], int const num, struct mah_chord_result_list* list,
+    struct mah_chord_base const* const* pos, int const size, mah_pitch_set const* masks, enum mah_error* err
+)
+{ // matches notes against pos, using masks if compiled or building each mask on the stack
+    mah_pitch_set set = to_pitch_set(notes, num);
+    int set_size      = count_pitch_set(set);
+    for (int s = 0; s < size; s++)
+    {
+        if (pos[s]->size < num)
+        {
+            continue;
+        }
+
+        mah_pitch_set mask = 0;
+        if (masks != NULL)
+        {
+            mask = masks[s];
+        }
+        else
+        {
+            enum mah_error chord_err = chord_mask(pos[s], &mask);
+            if (chord_err != MAH_ERROR_NONE)
+            {
+                SET_ERR(chord_err);
+                return;
+            }
+        }
+
+        if (count_pitch_set(mask) < set_size)
+        { // too few pitch classes to contain notes
+            continue;
+        }
+        for (int d = 0; d < SIZE_CHROMATIC; d++)
+        { // match every chord by rotating it up d semitones
+            if (IS_PITCH_SUBSET(set, ROTATE_PITCH_SET(mask, d)))
+            {
+                ADD_MATCHING_RESULT(MAH_ERROR_OVERFLOW_CHORD_RETURN, mah_chord_result, pos[s]);
+            }
+        }
+    }
+}
+
+static struct mah_chord_base const*
+find_symbol(char const text[], int const len)
+{ // one probe of the perfect hash, then a compare to reject text that is not a suffix
+    uint32_t hash = SYMBOL_SEED;
+    for (int i = 0; i < len; i++)
+    {
+        hash = SYMBOL_STEP(hash, text[i]);
+    }
+
+    struct chord_symbol const* symbol = &SYMBOL_TABLE[SYMBOL_SLOT(hash)];
+    if (symbol->chord == NULL || symbol->len != len || memcmp(symbol->text, text, len) != 0)
+    {
+        return NULL;
+    }
+    return symbol->chord;
+}
+
 // Functions //
 
 struct mah_chord
@@ -105,6 +299,8 @@ mah_get_chord(
     struct mah_note* restrict notes, enum mah_error* err
 )
 {
+    PROFILE(MAH_STATS_GET_CHORD);
+
     notes[0] = base[0] = root;
 
     for (int i = 1; i < type->size; i++)
@@ -129,6 +325,8 @@ mah_get_chord(
 void
 mah_invert_chord(struct mah_chord* chord, int const inv, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_INVERT_CHORD);
+
     if (inv >= chord->size || inv < 0)
     {
         SET_ERR(MAH_ERROR_INVALID_INVERSION);
@@ -153,51 +351,240 @@ mah_invert_chord(struct mah_chord* chord, int const inv, enum mah_error* err)
 
 void
 mah_return_chord(
-    struct mah_note const notes[], int const num, struct mah_chord_result_list* list, struct mah_chord_check* custom,
-    enum mah_error* err
+    struct mah_note const notes[], int const num, struct mah_chord_result_list* list,
+    struct mah_chord_check const* custom, enum mah_error* err
 )
 {
-    static struct mah_chord_base const* chord_pos[] = {
-        &MAH_MAJOR_TRIAD,      &MAH_MINOR_TRIAD,  &MAH_AUGMENTED_TRIAD,
-        &MAH_DIMINISHED_TRIAD, &MAH_DIMINISHED_7, &MAH_DOMINANT_7,
-    };
-    struct mah_chord_check* chord_list = custom ? custom
-                                                : &(struct mah_chord_check) {
-                                                      .pos   = chord_pos,
-                                                      .notes = (struct mah_note[4]) { 0 },
-                                                      .base  = (struct mah_note[4]) { 0 },
-                                                      .size  = sizeof(chord_pos) / sizeof(*chord_pos),
-                                                  };
-
-    bool* semi = chord_list->semi;
-    for (int s = 0; s < chord_list->size; s++)
-    {
-        if (chord_list->pos[s]->size < num)
+    PROFILE(MAH_STATS_RETURN_CHORD);
+
+    if (custom == NULL)
+    {
+        return_chords(notes, num, list, CHORD_POS, sizeof(CHORD_POS) / sizeof(*CHORD_POS), NULL, err);
+        return;
+    }
+    return_chords(notes, num, list, custom->pos, custom->size, NULL, err);
+}
+
+void
+mah_get_chord_dict(struct mah_chord_dict* dict, struct mah_chord_check const* custom, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_CHORD_DICT);
+
+    dict->pos  = custom ? custom->pos : CHORD_POS;
+    dict->size = custom ? custom->size : (int) (sizeof(CHORD_POS) / sizeof(*CHORD_POS));
+    if (dict->size > dict->max)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_CHORD_DICT);
+        return;
+    }
+
+    for (int s = 0; s < dict->size; s++)
+    {
+        enum mah_error chord_err = chord_mask(dict->pos[s], &dict->masks[s]);
+        if (chord_err != MAH_ERROR_NONE)
         {
-            continue;
+            SET_ERR(chord_err);
+            return;
         }
+    }
+}
 
-        enum mah_error chord_err = MAH_ERROR_NONE;
-        struct mah_chord base    = mah_get_chord(
-            (struct mah_note) {
-                   .tone = MAH_C,
-                   .acci = MAH_NATURAL,
-            },
-            chord_list->pos[s], chord_list->base, chord_list->notes, &chord_err
-        );
+void
+mah_return_chord_dict(
+    struct mah_note const notes[], int const num, struct mah_chord_result_list* list,
+    struct mah_chord_dict const* dict, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_RETURN_CHORD_DICT);
+
+    return_chords(notes, num, list, dict->pos, dict->size, dict->masks, err);
+}
+
+void
+mah_get_chord_index(struct mah_chord_index* index, struct mah_chord_check const* custom, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_CHORD_INDEX);
+
+    struct mah_chord_base const* const* pos = custom ? custom->pos : CHORD_POS;
+    int size = custom ? custom->size : (int) (sizeof(CHORD_POS) / sizeof(*CHORD_POS));
+
+    int* start = index->start;
+    memset(start, 0, sizeof(index->start));
+    for (int s = 0; s < size; s++)
+    { // first pass counts the (chord, root) pairs containing each pitch class set
+        mah_pitch_set mask       = 0;
+        enum mah_error chord_err = chord_mask(pos[s], &mask);
         if (chord_err != MAH_ERROR_NONE)
         {
             SET_ERR(chord_err);
             return;
         }
+        for (int d = 0; d < SIZE_CHROMATIC; d++)
+        {
+            mah_pitch_set chord = ROTATE_PITCH_SET(mask, d);
+            for (mah_pitch_set sub = chord;; sub = (sub - 1) & chord)
+            { // every subset of the chord, including the empty set
+                start[sub + 1]++;
+                if (sub == 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
 
-        fill_semi_table(semi, base.notes, base.size);
+    for (int p = 0; p < MAH_PITCH_SETS; p++)
+    {
+        start[p + 1] += start[p];
+    }
+    index->size = start[MAH_PITCH_SETS];
+    if (index->size > index->max)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_CHORD_INDEX);
+        return;
+    }
+
+    for (int s = 0; s < size; s++)
+    { // second pass fills entries in list order, using start[] as a cursor
+        mah_pitch_set mask = 0;
+        chord_mask(pos[s], &mask);
         for (int d = 0; d < SIZE_CHROMATIC; d++)
-        { // match every scale by semitone
-            if (has_shifted_matches(notes, num, semi, d))
+        {
+            mah_pitch_set chord = ROTATE_PITCH_SET(mask, d);
+            for (mah_pitch_set sub = chord;; sub = (sub - 1) & chord)
             {
-                ADD_MATCHING_RESULT(MAH_ERROR_OVERFLOW_CHORD_RETURN, mah_chord_result, chord_list->pos[s]);
+                index->entries[start[sub]++] = (struct mah_chord_index_entry) { pos[s], d };
+                if (sub == 0)
+                {
+                    break;
+                }
             }
         }
     }
+
+    for (int p = MAH_PITCH_SETS; p > 0; p--)
+    { // each cursor now points at the next set's start, so shift back
+        start[p] = start[p - 1];
+    }
+    start[0] = 0;
+}
+
+void
+mah_return_chord_index(
+    struct mah_note const notes[], int const num, struct mah_chord_result_list* list,
+    struct mah_chord_index const* index, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_RETURN_CHORD_INDEX);
+
+    mah_pitch_set set = to_pitch_set(notes, num);
+    for (int e = index->start[set]; e < index->start[set + 1]; e++)
+    {
+        struct mah_chord_index_entry const* entry = &index->entries[e];
+        if (entry->chord->size < num)
+        {
+            continue;
+        }
+
+        int d = entry->root;
+        ADD_MATCHING_RESULT(MAH_ERROR_OVERFLOW_CHORD_RETURN, mah_chord_result, entry->chord);
+    }
 }
+
+void
+mah_return_chord_batch(
+    struct mah_note const notes[], int const offsets[], int const num, struct mah_chord_result_list lists[],
+    struct mah_chord_index const* index, int const threads, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_RETURN_CHORD_BATCH);
+
+    struct chord_batch batch = { .notes = notes, .offsets = offsets, .lists = lists, .index = index };
+    int workers              = pool_workers(threads, num, CHORD_BATCH_MIN);
+    pool_start_fails(batch.fails, workers);
+    pool_run(workers, num, return_chord_task, &batch);
+
+    enum mah_error batch_err = pool_first_fail(batch.fails, workers);
+    if (batch_err != MAH_ERROR_NONE)
+    {
+        SET_ERR(batch_err);
+    }
+}
+
+struct mah_chord_result
+mah_read_chord_symbol(char const text[], size_t const len, size_t* read, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_READ_CHORD_SYMBOL);
+
+    if (read != NULL)
+    {
+        *read = 0;
+    }
+
+    struct mah_chord_result result = { { MAH_C, 0, MAH_OCTAVE_0 }, NULL };
+    size_t pos                     = read_pitch(text, len, &result.key);
+    if (pos == 0)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_chord_result, MAH_ERROR_INVALID_READ_CHORD);
+    }
+
+    size_t end = pos;
+    while (end < len && !is_text_sep(text[end]) && end - pos <= SYMBOL_MAX)
+    { // suffix runs to the next separator
+        end++;
+    }
+    if (end - pos > SYMBOL_MAX || (result.chord = find_symbol(text + pos, (int) (end - pos))) == NULL)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_chord_result, MAH_ERROR_INVALID_READ_CHORD);
+    }
+
+    if (read != NULL)
+    {
+        *read = end;
+    }
+    return result;
+}
+
+char*
+mah_write_chord_symbol(struct mah_chord_result const result, char buf[], size_t const size, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_WRITE_CHORD_SYMBOL);
+
+    enum mah_error note_err = check_print_note(result.key);
+    if (note_err != MAH_ERROR_NONE)
+    {
+        SET_ERR(note_err);
+        return "";
+    }
+
+    struct chord_symbol const* symbol = NULL;
+    for (size_t i = 0; i < sizeof(SYMBOL_WRITE) / sizeof(*SYMBOL_WRITE); i++)
+    {
+        if (SYMBOL_WRITE[i].chord == result.chord)
+        {
+            symbol = &SYMBOL_WRITE[i];
+            break;
+        }
+    }
+    if (symbol == NULL)
+    {
+        SET_ERR(MAH_ERROR_INVALID_PRINT_CHORD);
+        return "";
+    }
+
+    char text[SYMBOL_TEXT_MAX + SYMBOL_MAX + 1];
+    size_t len = write_pitch(result.key, text);
+    memcpy(text + len, symbol->text, symbol->len);
+    len += symbol->len;
+    if (size > 0)
+    { // truncated like mah_write_note
+        size_t copy = len < size ? len : size - 1;
+        memcpy(buf, text, copy);
+        buf[copy] = '\0';
+    }
+    if (len >= size)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_PRINT_CHORD);
+    }
+    return buf;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef __MAH_CHD_H__
 #define __MAH_CHD_H__
 
+#include "arena/arena.h"
 #include "err/err.h"
 #include "inter/inter.h"
 #include "note/note.h"
@@ -34,17 +35,37 @@ typedef struct mah_chord_result_list
     int max;
     int size;
     struct mah_chord_result* results;
+    struct mah_arena* arena; // grows results when full (optional)
 } mah_chord_result_list;
 
 typedef struct mah_chord_check
 {
     struct mah_chord_base const** pos;
     int size;
-    struct mah_note* restrict base;
-    struct mah_note* restrict notes;
-    bool semi[SIZE_CHROMATIC];
 } mah_chord_check;
 
+typedef struct mah_chord_dict
+{ // compiled chord list, read only once built
+    struct mah_chord_base const** pos;
+    int size;
+    int max;
+    mah_pitch_set* masks;
+} mah_chord_dict;
+
+typedef struct mah_chord_index_entry
+{
+    struct mah_chord_base const* chord;
+    int root;
+} mah_chord_index_entry;
+
+typedef struct mah_chord_index
+{
+    int max;
+    int size;
+    struct mah_chord_index_entry* entries;
+    int start[MAH_PITCH_SETS + 1];
+} mah_chord_index;
+
 // Preset Chords //
 
 extern struct mah_chord_base const MAH_MAJOR_TRIAD;       // Major Triad
@@ -64,9 +85,25 @@ struct mah_chord mah_get_chord(
     struct mah_note* restrict notes, enum mah_error* err
 );
 void mah_return_chord(
-    struct mah_note const notes[], int note, struct mah_chord_result_list* list, struct mah_chord_check* custom,
+    struct mah_note const notes[], int note, struct mah_chord_result_list* list, struct mah_chord_check const* custom,
     enum mah_error* err
 );
+void mah_get_chord_dict(struct mah_chord_dict* dict, struct mah_chord_check const* custom, enum mah_error* err);
+void mah_return_chord_dict(
+    struct mah_note const notes[], int num, struct mah_chord_result_list* list, struct mah_chord_dict const* dict,
+    enum mah_error* err
+);
+void mah_get_chord_index(struct mah_chord_index* index, struct mah_chord_check const* custom, enum mah_error* err);
+void mah_return_chord_index(
+    struct mah_note const notes[], int num, struct mah_chord_result_list* list, struct mah_chord_index const* index,
+    enum mah_error* err
+);
+void mah_return_chord_batch(
+    struct mah_note const notes[], int const offsets[], int num, struct mah_chord_result_list lists[],
+    struct mah_chord_index const* index, int threads, enum mah_error* err
+);
 void mah_invert_chord(struct mah_chord* chord, int inv, enum mah_error* err);
+struct mah_chord_result mah_read_chord_symbol(char const text[], size_t len, size_t* read, enum mah_error* err);
+char* mah_write_chord_symbol(struct mah_chord_result result, char buf[], size_t size, enum mah_error* err);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,276 @@
+/*
+
+| corpus.c |
+Defines the columnar corpus format for mah_timed_note sequences
+A header is followed by one array per field, so a memory mapped file is read in place without parsing
+
+*/
+
+#include "corpus/corpus.h"
+#include "shared/shared.h"
+#include <limits.h>
+#include <string.h>
+
+// Macros //
+
+#define CORPUS_HEADER 32         // bytes of struct corpus_header, padded to MAH_BATCH_ALIGN
+#define CORPUS_ORDER 0x01020304u // written in native byte order, read back unchanged only on the same byte order
+
+// Bytes of one note in every column, which also tells readers with other type sizes apart
+#define CORPUS_NOTE_BYTES                                                                                              \
+    (sizeof(uint64_t) + sizeof(enum mah_tone) + sizeof(int) + sizeof(enum mah_octave) + sizeof(enum mah_dur) +         \
+     sizeof(int))
+
+// Rounds n up to the alignment of columns
+#define ALIGN_COLUMN(n) (((n) + MAH_BATCH_ALIGN - 1) / MAH_BATCH_ALIGN * MAH_BATCH_ALIGN)
+
+// Stores value as element n of the column at byte offset column of data (which may be unaligned)
+#define PUT_COLUMN(data, column, n, value) memcpy((data) + (column) + (n) * sizeof(value), &(value), sizeof(value))
+
+// Structures //
+
+enum corpus_column
+{ // columns in file order
+    COLUMN_OFFSETS,
+    COLUMN_START,
+    COLUMN_TONE,
+    COLUMN_ACCI,
+    COLUMN_OCTAVE,
+    COLUMN_DURATION,
+    COLUMN_TUPLET,
+    COLUMN_TUPLETS,
+    COLUMNS
+};
+
+struct corpus_header
+{
+    char magic[4];       // "MAHC"
+    uint32_t version;    // MAH_CORPUS_VERSION
+    uint32_t order;      // CORPUS_ORDER
+    uint32_t pieces;     // pieces in file
+    uint64_t notes;      // notes of all pieces
+    uint32_t tuplets;    // entries of tuplet table
+    uint32_t note_bytes; // CORPUS_NOTE_BYTES of the writer
+};
+
+// Internal Functions //
+
+static size_t
+corpus_layout(size_t const pieces, uint64_t const notes, size_t const tuplets, size_t column[COLUMNS + 1])
+{ // fills the byte offset of each column from the start of the file, returns the file size (also in column[COLUMNS])
+    size_t const bytes[COLUMNS] = {
+        [COLUMN_OFFSETS]  = (pieces + 1) * sizeof(uint64_t),
+        [COLUMN_START]    = notes * sizeof(uint64_t),
+        [COLUMN_TONE]     = notes * sizeof(enum mah_tone),
+        [COLUMN_ACCI]     = notes * sizeof(int),
+        [COLUMN_OCTAVE]   = notes * sizeof(enum mah_octave),
+        [COLUMN_DURATION] = notes * sizeof(enum mah_dur),
+        [COLUMN_TUPLET]   = notes * sizeof(int),
+        [COLUMN_TUPLETS]  = tuplets * sizeof(struct mah_tuplet),
+    };
+
+    column[0] = CORPUS_HEADER;
+    for (int c = 0; c < COLUMNS; c++)
+    {
+        column[c + 1] = ALIGN_COLUMN(column[c] + bytes[c]);
+    }
+    return column[COLUMNS];
+}
+
+static bool
+corpus_tuplets_valid(enum mah_dur const duration[], int const tuplet[], uint64_t const notes, uint32_t const tuplets)
+{ // true if every note names a stored tuplet exactly when its duration is MAH_TUPLET
+    for (uint64_t n = 0; n < notes; n++)
+    {
+        if ((unsigned) duration[n] > MAH_TUPLET ||
+            (duration[n] == MAH_TUPLET ? tuplet[n] <= 0 || (uint32_t) tuplet[n] > tuplets : tuplet[n] != 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int
+piece_tuplet(struct mah_timed_note const* note, struct mah_tuplet_table* table, enum mah_error* err)
+{ // returns index + 1 of the tuplet of note in table, 0 if it has none (or on error)
+    return note->duration == MAH_TUPLET ? find_tuplet(table, note->tuplet, err) : 0;
+}
+
+// Functions //
+
+void
+mah_write_corpus(
+    struct mah_timed_note const notes[], size_t const offsets[], int const pieces, struct mah_tuplet_table* table,
+    struct mah_buffer* out, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_WRITE_CORPUS);
+
+    if (pieces < 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return;
+    }
+
+    for (int p = 0; p < pieces; p++)
+    { // first pass checks every note and fills table with their tuplets
+        if (offsets[p + 1] < offsets[p])
+        {
+            SET_ERR(MAH_ERROR_INVALID_RANGE);
+            return;
+        }
+        for (size_t i = offsets[p]; i < offsets[p + 1]; i++)
+        {
+            struct mah_timed_note note = notes[i];
+            enum mah_error note_err    = MAH_ERROR_NONE;
+            mah_get_duration_ticks(&note, &note_err);
+            if (note_err == MAH_ERROR_NONE)
+            {
+                piece_tuplet(&note, table, &note_err);
+            }
+            if (note_err != MAH_ERROR_NONE)
+            {
+                SET_ERR(note_err);
+                return;
+            }
+        }
+    }
+
+    size_t first = offsets[0];
+    size_t num   = offsets[pieces] - first;
+    int tuplets  = table ? table->size : 0;
+    size_t column[COLUMNS + 1];
+    size_t size = corpus_layout((size_t) pieces, num, (size_t) tuplets, column);
+
+    out->size = size;
+    if (size > out->max)
+    {
+        unsigned char* data = out->arena ? mah_arena_alloc(out->arena, size, MAH_BATCH_ALIGN, NULL) : NULL;
+        if (data == NULL)
+        {
+            SET_ERR(MAH_ERROR_OVERFLOW_CORPUS);
+            return;
+        }
+        out->data = data;
+        out->max  = size;
+    }
+
+    // second pass writes the columns, padding between them is zeroed so equal corpora give equal files
+    unsigned char* data         = out->data;
+    struct corpus_header header = {
+        .magic      = { 'M', 'A', 'H', 'C' },
+        .version    = MAH_CORPUS_VERSION,
+        .order      = CORPUS_ORDER,
+        .pieces     = (uint32_t) pieces,
+        .notes      = num,
+        .tuplets    = (uint32_t) tuplets,
+        .note_bytes = CORPUS_NOTE_BYTES,
+    };
+    memset(data, 0, size);
+    memcpy(data, &header, sizeof(header));
+    if (tuplets > 0)
+    {
+        memcpy(data + column[COLUMN_TUPLETS], table->tuplets, (size_t) tuplets * sizeof(struct mah_tuplet));
+    }
+
+    for (int p = 0; p <= pieces; p++)
+    {
+        uint64_t offset = offsets[p] - first;
+        PUT_COLUMN(data, column[COLUMN_OFFSETS], (size_t) p, offset);
+    }
+    for (int p = 0; p < pieces; p++)
+    {
+        uint64_t tick = 0;
+        for (size_t i = offsets[p]; i < offsets[p + 1]; i++)
+        {
+            struct mah_timed_note note = notes[i];
+            size_t n                   = i - first;
+            int tuplet                 = piece_tuplet(&note, table, NULL);
+            PUT_COLUMN(data, column[COLUMN_START], n, tick);
+            PUT_COLUMN(data, column[COLUMN_TONE], n, note.tone_timed);
+            PUT_COLUMN(data, column[COLUMN_ACCI], n, note.acci_timed);
+            PUT_COLUMN(data, column[COLUMN_OCTAVE], n, note.octave_timed);
+            PUT_COLUMN(data, column[COLUMN_DURATION], n, note.duration);
+            PUT_COLUMN(data, column[COLUMN_TUPLET], n, tuplet);
+            tick += (uint64_t) mah_get_duration_ticks(&note, &(enum mah_error) { 0 });
+        }
+    }
+}
+
+struct mah_corpus
+mah_read_corpus(unsigned char data[], size_t const size, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_READ_CORPUS);
+
+    struct corpus_header header;
+    if (size < CORPUS_HEADER || (uintptr_t) data % MAH_CORPUS_ALIGN != 0)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_corpus, MAH_ERROR_INVALID_CORPUS);
+    }
+    memcpy(&header, data, sizeof(header));
+
+    // counts are bounded by size before the layout is computed, so it can not overflow
+    if (memcmp(header.magic, "MAHC", 4) != 0 || header.version != MAH_CORPUS_VERSION ||
+        header.order != CORPUS_ORDER || header.note_bytes != CORPUS_NOTE_BYTES || header.pieces > INT_MAX ||
+        header.pieces >= size / sizeof(uint64_t) || header.notes > size / CORPUS_NOTE_BYTES ||
+        header.tuplets > MAH_TUPLET_TABLE_MAX)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_corpus, MAH_ERROR_INVALID_CORPUS);
+    }
+
+    size_t column[COLUMNS + 1];
+    uint64_t const* offsets = (uint64_t const*) (data + CORPUS_HEADER);
+    if (corpus_layout(header.pieces, header.notes, header.tuplets, column) > size || offsets[0] != 0 ||
+        offsets[header.pieces] != header.notes ||
+        !corpus_tuplets_valid(
+            (enum mah_dur const*) (data + column[COLUMN_DURATION]), (int const*) (data + column[COLUMN_TUPLET]),
+            header.notes, header.tuplets
+        ))
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_corpus, MAH_ERROR_INVALID_CORPUS);
+    }
+
+    return (struct mah_corpus) {
+        .data     = data,
+        .size     = size,
+        .pieces   = (int) header.pieces,
+        .notes    = header.notes,
+        .offsets  = offsets,
+        .start    = (uint64_t const*) (data + column[COLUMN_START]),
+        .tone     = (enum mah_tone*) (data + column[COLUMN_TONE]),
+        .acci     = (int*) (data + column[COLUMN_ACCI]),
+        .octave   = (enum mah_octave*) (data + column[COLUMN_OCTAVE]),
+        .duration = (enum mah_dur const*) (data + column[COLUMN_DURATION]),
+        .tuplet   = (int const*) (data + column[COLUMN_TUPLET]),
+        .tuplets  = {
+            (int) header.tuplets, (int) header.tuplets, (struct mah_tuplet*) (data + column[COLUMN_TUPLETS]),
+        },
+    };
+}
+
+struct mah_note_batch
+mah_get_corpus_piece(struct mah_corpus const* corpus, int const piece, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_CORPUS_PIECE);
+
+    if (piece < 0 || piece >= corpus->pieces)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_note_batch, MAH_ERROR_INVALID_RANGE);
+    }
+
+    // offsets are checked here rather than in mah_read_corpus, so opening a corpus does not read them all
+    uint64_t first = corpus->offsets[piece];
+    uint64_t last  = corpus->offsets[piece + 1];
+    if (first > last || last > corpus->notes || last - first > INT_MAX)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_note_batch, MAH_ERROR_INVALID_CORPUS);
+    }
+
+    return (struct mah_note_batch) {
+        .tone   = corpus->tone + first,
+        .acci   = corpus->acci + first,
+        .octave = corpus->octave + first,
+        .size   = (int) (last - first),
+    };
+}
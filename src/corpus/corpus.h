@@ -0,0 +1,43 @@
+#ifndef __MAH_CORPUS_H__
+#define __MAH_CORPUS_H__
+
+#include "arena/arena.h"
+#include "err/err.h"
+#include "note/note.h"
+#include "pack/pack.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Macros //
+
+#define MAH_CORPUS_VERSION 1 // format version written by mah_write_corpus
+#define MAH_CORPUS_ALIGN 8   // required alignment (in bytes) of corpus data given to mah_read_corpus
+
+// Structures //
+
+typedef struct mah_corpus
+{
+    unsigned char* data;             // whole file, not copied
+    size_t size;                     // bytes in data
+    int pieces;                      // pieces in file
+    uint64_t notes;                  // notes of all pieces
+    uint64_t const* offsets;         // first note of each piece, pieces + 1 entries
+    uint64_t const* start;           // ticks from start of piece to each note
+    enum mah_tone* tone;             // columns of notes, aligned to MAH_BATCH_ALIGN if data is
+    int* acci;
+    enum mah_octave* octave;
+    enum mah_dur const* duration;
+    int const* tuplet;               // index + 1 into tuplets, 0 for no tuplet
+    struct mah_tuplet_table tuplets; // tuplets of all pieces
+} mah_corpus;
+
+// Functions //
+
+void mah_write_corpus(
+    struct mah_timed_note const notes[], size_t const offsets[], int pieces, struct mah_tuplet_table* table,
+    struct mah_buffer* out, enum mah_error* err
+);
+struct mah_corpus mah_read_corpus(unsigned char data[], size_t size, enum mah_error* err);
+struct mah_note_batch mah_get_corpus_piece(struct mah_corpus const* corpus, int piece, enum mah_error* err);
+
+#endif
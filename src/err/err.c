@@ -47,6 +47,56 @@ mah_get_error(enum mah_error const err)
         return "Invalid Nontertian Chord Size";
     case MAH_ERROR_INVALID_FOLD_LEVEL:
         return "Invalid Fold Level";
+    case MAH_ERROR_OVERFLOW_CHORD_INDEX:
+        return "Too many Chord Index Entries";
+    case MAH_ERROR_OVERFLOW_SCALE_INDEX:
+        return "Too many Scale Index Entries";
+    case MAH_ERROR_INVALID_PACK_NOTE:
+        return "Out of Range Note for Pack Note";
+    case MAH_ERROR_OVERFLOW_TUPLET_TABLE:
+        return "Too many Tuplet Table Entries";
+    case MAH_ERROR_OVERFLOW_ARENA:
+        return "Arena is Full";
+    case MAH_ERROR_OVERFLOW_CHORD_DICT:
+        return "Too many Chords for Chord Dictionary";
+    case MAH_ERROR_OVERFLOW_SCALE_DICT:
+        return "Too many Scales for Scale Dictionary";
+    case MAH_ERROR_INVALID_READ_NOTE:
+        return "Invalid Note Text for Read Note";
+    case MAH_ERROR_OVERFLOW_READ_NOTE:
+        return "Too many Notes in Text";
+    case MAH_ERROR_INVALID_READ_CHORD:
+        return "Invalid Chord Symbol for Read Chord";
+    case MAH_ERROR_INVALID_PRINT_CHORD:
+        return "Chord has no Symbol for Print Chord";
+    case MAH_ERROR_OVERFLOW_PRINT_CHORD:
+        return "Chord Symbol Text is too Large";
+    case MAH_ERROR_INVALID_MIDI:
+        return "Invalid or Truncated MIDI File";
+    case MAH_ERROR_OVERFLOW_MIDI:
+        return "MIDI File is too Large for Buffer";
+    case MAH_ERROR_INVALID_CORPUS:
+        return "Invalid, Truncated or Unaligned Corpus File";
+    case MAH_ERROR_OVERFLOW_CORPUS:
+        return "Corpus File is too Large for Buffer";
+    case MAH_ERROR_INVALID_NOTE_STREAM:
+        return "Invalid Note Stream for Decode Notes";
+    case MAH_ERROR_OVERFLOW_NOTE_STREAM:
+        return "Note Stream is too Large for Buffer";
+    case MAH_ERROR_OVERFLOW_TIMELINE:
+        return "Timeline Resolution or Position is too Large";
+    case MAH_ERROR_OVERFLOW_MEASURE_RETURN:
+        return "Too many Measure Mismatches for List";
+    case MAH_ERROR_INVALID_SPLIT:
+        return "Split Note can not be Written with Durations";
+    case MAH_ERROR_OVERFLOW_TIE_RETURN:
+        return "Too many Tied Notes for List";
+    case MAH_ERROR_INVALID_QUANTIZE:
+        return "Invalid Grid, Tempo or Onsets for Quantize";
+    case MAH_ERROR_OVERFLOW_QUANTIZE:
+        return "Too many Quantized Notes for Buffer";
+    case MAH_ERROR_INVALID_TEMPO:
+        return "Invalid or Unordered Tempo Changes";
     default:
         return "Unknown Error";
     }
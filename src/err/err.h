@@ -22,7 +22,32 @@ typedef enum mah_error
     MAH_ERROR_INVALID_TIME_SIG,
     MAH_ERROR_INVALID_DURATION,
     MAH_ERROR_INVALID_NONTERTIAN_SIZE,
-    MAH_ERROR_INVALID_FOLD_LEVEL
+    MAH_ERROR_INVALID_FOLD_LEVEL,
+    MAH_ERROR_OVERFLOW_CHORD_INDEX,
+    MAH_ERROR_OVERFLOW_SCALE_INDEX,
+    MAH_ERROR_INVALID_PACK_NOTE,
+    MAH_ERROR_OVERFLOW_TUPLET_TABLE,
+    MAH_ERROR_OVERFLOW_ARENA,
+    MAH_ERROR_OVERFLOW_CHORD_DICT,
+    MAH_ERROR_OVERFLOW_SCALE_DICT,
+    MAH_ERROR_INVALID_READ_NOTE,
+    MAH_ERROR_OVERFLOW_READ_NOTE,
+    MAH_ERROR_INVALID_READ_CHORD,
+    MAH_ERROR_INVALID_PRINT_CHORD,
+    MAH_ERROR_OVERFLOW_PRINT_CHORD,
+    MAH_ERROR_INVALID_MIDI,
+    MAH_ERROR_OVERFLOW_MIDI,
+    MAH_ERROR_INVALID_CORPUS,
+    MAH_ERROR_OVERFLOW_CORPUS,
+    MAH_ERROR_INVALID_NOTE_STREAM,
+    MAH_ERROR_OVERFLOW_NOTE_STREAM,
+    MAH_ERROR_OVERFLOW_TIMELINE,
+    MAH_ERROR_OVERFLOW_MEASURE_RETURN,
+    MAH_ERROR_INVALID_SPLIT,
+    MAH_ERROR_OVERFLOW_TIE_RETURN,
+    MAH_ERROR_INVALID_QUANTIZE,
+    MAH_ERROR_OVERFLOW_QUANTIZE,
+    MAH_ERROR_INVALID_TEMPO
 } mah_error;
 
 // Functions //
@@ -14,14 +14,110 @@ Defines global variable INTER_STEPS used by various functions
 
 #define ADJUST_NOTE 7      // Size of note scale (enum mahler_note)
 #define SIMPLE_INTER_MAX 8 // Simple Interval maximum
-#define SEMI_DIFF 3        // adjust for semitone difference
-#define TONE_DIFF 9        // adjust for tone (enum mahler_note) difference
+#define QUAL_MIN -2        // Lowest quality in table (MAH_DIMINISHED)
+#define QUAL_SIZE 6        // Qualities in table (MAH_DIMINISHED -> MAH_PERFECT)
+#define RAW_MIN -2         // Lowest semitone difference from a major / perfect interval in table
+#define RAW_SIZE 16        // Semitone differences in table (-2 -> 13, 11 -> 13 wrap to one below)
+
+#define IS_PERFECT(step) ((step) == 0 || (step) == 3 || (step) == 4) // simple interval (0 -> 6) is perfect
+
+// True if quality can be used with simple interval step
+#define QUAL_VALID(step, qual)                                                                                         \
+    (IS_PERFECT(step) ? (qual) == MAH_PERFECT || (qual) == MAH_AUGMENTED || (qual) == MAH_DIMINISHED                   \
+                      : (qual) != MAH_PERFECT)
+
+// Semitones quality adds to the major or perfect simple interval step
+#define QUAL_ADJ(step, qual)                                                                                           \
+    (IS_PERFECT(step) ? ((qual) == MAH_PERFECT ? 0 : (qual) == MAH_AUGMENTED ? 1 : -1) : (qual))
+
+// Entry of INTER_TABLE for starting tone t, simple interval step and quality
+#define INTER_ENTRY(t, step, qual)                                                                                     \
+    {                                                                                                                  \
+        .tone   = ((t) + (step)) % ADJUST_NOTE,                                                                        \
+        .octave = (t) + (step) >= ADJUST_NOTE,                                                                         \
+        .acci   = QUAL_VALID(step, qual) * (SEMITONE(t) + SEMITONE(step) + QUAL_ADJ(step, qual) -                      \
+                                          SEMITONE(((t) + (step)) % ADJUST_NOTE) -                                     \
+                                          SIZE_CHROMATIC * ((t) + (step) >= ADJUST_NOTE)),                             \
+        .err    = QUAL_VALID(step, qual) ? MAH_ERROR_NONE : MAH_ERROR_INVALID_QUAL,                                    \
+    }
+#define INTER_ROW(t, step)                                                                                             \
+    {                                                                                                                  \
+        INTER_ENTRY(t, step, -2), INTER_ENTRY(t, step, -1), INTER_ENTRY(t, step, 0), INTER_ENTRY(t, step, 1),          \
+            INTER_ENTRY(t, step, 2), INTER_ENTRY(t, step, 3),                                                          \
+    }
+#define INTER_TONE(t)                                                                                                  \
+    {                                                                                                                  \
+        INTER_ROW(t, 0), INTER_ROW(t, 1), INTER_ROW(t, 2), INTER_ROW(t, 3), INTER_ROW(t, 4), INTER_ROW(t, 5),          \
+            INTER_ROW(t, 6),                                                                                           \
+    }
+
+// Entry of RETURN_TABLE for tones a and b
+#define RETURN_ENTRY(a, b)                                                                                             \
+    {                                                                                                                  \
+        .semi    = SEMITONE(b) - SEMITONE(a) - SEMITONE(((b) - (a) + ADJUST_NOTE) % ADJUST_NOTE),                      \
+        .perfect = IS_PERFECT(((b) - (a) + ADJUST_NOTE) % ADJUST_NOTE),                                                \
+    }
+#define RETURN_ROW(a)                                                                                                  \
+    {                                                                                                                  \
+        RETURN_ENTRY(a, 0), RETURN_ENTRY(a, 1), RETURN_ENTRY(a, 2), RETURN_ENTRY(a, 3), RETURN_ENTRY(a, 4),            \
+            RETURN_ENTRY(a, 5), RETURN_ENTRY(a, 6),                                                                    \
+    }
+
+// Entry of QUAL_TABLE for semitone difference diff from the major or perfect interval
+#define QUAL_ENTRY(perf, diff)                                                                                         \
+    {                                                                                                                  \
+        .qual = (perf) && ((diff) == 0 || (diff) == 12)    ? MAH_PERFECT                                               \
+                : (perf) && ((diff) == -1 || (diff) == 11) ? MAH_DIMINISHED                                            \
+                : (diff) >= 11                             ? (diff) - SIZE_CHROMATIC                                   \
+                                                           : (diff),                                                   \
+        .err  = (diff) <= 1 || (diff) >= 11 ? MAH_ERROR_NONE : MAH_ERROR_INVALID_QUAL,                                 \
+    }
+#define QUAL_ROW(perf)                                                                                                 \
+    {                                                                                                                  \
+        QUAL_ENTRY(perf, -2), QUAL_ENTRY(perf, -1), QUAL_ENTRY(perf, 0), QUAL_ENTRY(perf, 1), QUAL_ENTRY(perf, 2),     \
+            QUAL_ENTRY(perf, 3), QUAL_ENTRY(perf, 4), QUAL_ENTRY(perf, 5), QUAL_ENTRY(perf, 6), QUAL_ENTRY(perf, 7),   \
+            QUAL_ENTRY(perf, 8), QUAL_ENTRY(perf, 9), QUAL_ENTRY(perf, 10), QUAL_ENTRY(perf, 11),                      \
+            QUAL_ENTRY(perf, 12), QUAL_ENTRY(perf, 13),                                                                \
+    }
+
+// Structures //
+
+struct inter_entry
+{
+    signed char tone;   // destination tone
+    signed char octave; // 1 if destination wraps past B
+    signed char acci;   // added to the accidental of the starting note
+    signed char err;
+};
+
+struct return_entry
+{
+    signed char semi;    // semitones between tones, minus those of the major or perfect interval
+    signed char perfect; // 1 if the simple interval is perfect
+};
+
+struct qual_entry
+{
+    signed char qual;
+    signed char err;
+};
 
 // Global Variables //
 
-static int const INTER_STEPS[] = {
-    // Semitone distance between major intervals
-    0, 2, 4, 5, 7, 9, 11, 12,
+static struct inter_entry const INTER_TABLE[ADJUST_NOTE][ADJUST_NOTE][QUAL_SIZE] = {
+    // Destination of every simple interval, by starting tone, interval - 1 and quality - QUAL_MIN
+    INTER_TONE(0), INTER_TONE(1), INTER_TONE(2), INTER_TONE(3), INTER_TONE(4), INTER_TONE(5), INTER_TONE(6),
+};
+
+static struct return_entry const RETURN_TABLE[ADJUST_NOTE][ADJUST_NOTE] = {
+    // Interval between every pair of tones, by tone of note_a and tone of note_b
+    RETURN_ROW(0), RETURN_ROW(1), RETURN_ROW(2), RETURN_ROW(3), RETURN_ROW(4), RETURN_ROW(5), RETURN_ROW(6),
+};
+
+static struct qual_entry const QUAL_TABLE[2][RAW_SIZE] = {
+    // Quality of a semitone difference from major or perfect, by whether the interval is perfect
+    QUAL_ROW(0),
+    QUAL_ROW(1),
 };
 
 // Functions //
@@ -29,100 +125,176 @@ static int const INTER_STEPS[] = {
 struct mah_note
 mah_get_inter(struct mah_note const note, struct mah_interval const interval, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_GET_INTER);
+
     if (interval.steps <= 0)
     {
         RETURN_EMPTY_STRUCT_ERR(mah_note, MAH_ERROR_INVALID_RANGE);
     }
-    int inter   = (interval.steps - 1) % ADJUST_NOTE;
-    int pitch   = note.octave + (interval.steps / SIMPLE_INTER_MAX);
-    int root    = note.tone;
-    int quality = interval.qual;
-
-    int semi = 0;
-    if (inter == 0 || inter == 3 || inter == 4 || inter == 7)
-    { // if perfect interval
-        switch (quality)
-        { // special semitone adjustment for perfect interval
-        case MAH_AUGMENTED:
-            semi = 0;
-            break;
-        case MAH_DIMINISHED:
-            semi = 1;
-            break;
-        case MAH_PERFECT:
-            semi = -3;
-            break;
-        default:
-            RETURN_EMPTY_STRUCT_ERR(mah_note, MAH_ERROR_INVALID_QUAL);
-        }
-    }
-    else if (quality == MAH_PERFECT)
+    if (note.tone < MAH_C || note.tone > MAH_B)
     {
-        RETURN_EMPTY_STRUCT_ERR(mah_note, MAH_ERROR_INVALID_QUAL);
+        RETURN_EMPTY_STRUCT_ERR(mah_note, MAH_ERROR_INVALID_RANGE);
     }
+    int inter = (interval.steps - 1) % ADJUST_NOTE;
 
-    int enharmonic = root + inter; // find enharmonicically correct note by ignoring acci
-    bool above     = false;
-    if (enharmonic >= ADJUST_NOTE)
+    struct inter_entry entry;
+    if (interval.qual >= QUAL_MIN && interval.qual < QUAL_MIN + QUAL_SIZE)
+    {
+        entry = INTER_TABLE[note.tone][inter][interval.qual - QUAL_MIN];
+    }
+    else
+    { // qualities outside the table are only valid for non perfect intervals, as an offset from major
+        entry = INTER_TABLE[note.tone][inter][MAH_MAJOR - QUAL_MIN];
+        entry.err = IS_PERFECT(inter) ? MAH_ERROR_INVALID_QUAL : MAH_ERROR_NONE;
+        entry.acci += interval.qual * !IS_PERFECT(inter);
+    }
+    if (entry.err != MAH_ERROR_NONE)
     {
-        above = true;
-        pitch += 1;
+        RETURN_EMPTY_STRUCT_ERR(mah_note, entry.err);
     }
-    semi += to_semitone(root) + INTER_STEPS[inter] + note.acci + quality - 1;
 
     return (struct mah_note) {
-        .tone  = enharmonic - (above * ADJUST_NOTE),
-        .acci  = above ? semi - (to_semitone(enharmonic) - SEMI_DIFF) - (enharmonic <= TONE_DIFF)
-                       : semi - (to_semitone(enharmonic) - 1), // 7 -> 9 is C to E (see toSemitone),
-        .octave = pitch,
+        .tone   = entry.tone,
+        .acci   = note.acci + entry.acci,
+        .octave = note.octave + (interval.steps / SIMPLE_INTER_MAX) + entry.octave,
     };
 }
 
 struct mah_interval
 mah_return_inter(struct mah_note const note_a, struct mah_note const note_b, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_RETURN_INTER);
 
-    int inter = (note_b.tone + note_b.octave * ADJUST_NOTE) - (note_a.tone + note_a.octave * ADJUST_NOTE) + 1;
-    int pitch = inter > SIMPLE_INTER_MAX ? note_b.octave - (inter / SIMPLE_INTER_MAX) : note_b.octave;
 
-    if (inter <= 0)
+    int inter = (note_b.tone + note_b.octave * ADJUST_NOTE) - (note_a.tone + note_a.octave * ADJUST_NOTE) + 1;
+    if (inter <= 0 || note_a.tone < MAH_C || note_a.tone > MAH_B || note_b.tone < MAH_C || note_b.tone > MAH_B)
     {
         RETURN_EMPTY_STRUCT_ERR(mah_interval, MAH_ERROR_INVALID_RANGE);
     }
+    int pitch = inter > SIMPLE_INTER_MAX ? note_b.octave - (inter / SIMPLE_INTER_MAX) : note_b.octave;
 
-    int steps = (inter % ADJUST_NOTE) - 1; // - 1 since used for array indice of INTER_STEPS
-    if (steps == -1)
-    {
-        steps = 6;
-    }
-
-    int quality = (to_semitone(note_b.tone) + note_b.acci + pitch * SIZE_CHROMATIC) -
-                  (to_semitone(note_a.tone) + note_a.acci + note_a.octave * SIZE_CHROMATIC) - INTER_STEPS[steps];
-
-    if (quality >= 11 && quality <= 13)
-    { // treated as 1 so must adjust (C0 12 = C1 0)
-        quality -= SIZE_CHROMATIC;
-    }
-    else if (quality < -2 || quality > 1)
+    struct return_entry entry = RETURN_TABLE[note_a.tone][note_b.tone];
+    int raw = entry.semi + note_b.acci - note_a.acci + (pitch - note_a.octave) * SIZE_CHROMATIC - RAW_MIN;
+    if (raw < 0 || raw >= RAW_SIZE)
     { // between diminished and augmented
         RETURN_EMPTY_STRUCT_ERR(mah_interval, MAH_ERROR_INVALID_QUAL);
     }
 
-    int chk_perf = inter % ADJUST_NOTE;
-    if (chk_perf == 1 || chk_perf == 4 || chk_perf == 5)
+    struct qual_entry qual = QUAL_TABLE[entry.perfect][raw];
+    if (qual.err != MAH_ERROR_NONE)
     {
-        if (quality == MAH_MAJOR)
-        {
-            quality = MAH_PERFECT;
-        }
-        else if (quality == MAH_MINOR)
-        {
-            quality = MAH_DIMINISHED;
-        }
+        RETURN_EMPTY_STRUCT_ERR(mah_interval, qual.err);
     }
 
     return (struct mah_interval) {
         .steps = inter,
-        .qual  = quality,
+        .qual  = qual.qual,
     };
+}
+
+void
+mah_get_inter_batch(
+    struct mah_note_batch const* notes, struct mah_interval const interval, struct mah_note_batch* out,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_GET_INTER_BATCH);
+
+    // interval from C validates the interval once for the whole batch
+    enum mah_error base_err = MAH_ERROR_NONE;
+    struct mah_note base    = mah_get_inter((struct mah_note) { MAH_C, MAH_NATURAL, MAH_OCTAVE_0 }, interval, &base_err);
+    if (base_err != MAH_ERROR_NONE)
+    {
+        SET_ERR(base_err);
+        return;
+    }
+
+    int step   = base.tone;
+    int semi   = SEMITONE(base.tone) + base.acci;
+    int octave = interval.steps / SIMPLE_INTER_MAX;
+
+    // locals so stores to out can not alias the loop bounds, out may be notes
+    int size                   = notes->size;
+    enum mah_tone const* tone  = notes->tone;
+    int const* acci            = notes->acci;
+    enum mah_octave const* oct = notes->octave;
+    enum mah_tone* out_tone    = out->tone;
+    int* out_acci              = out->acci;
+    enum mah_octave* out_oct   = out->octave;
+
+    int invalid = 0;
+    VECTORIZE_LOOP
+    for (int i = 0; i < size; i++)
+    {
+        int t     = tone[i];
+        int valid = (t >= MAH_C) & (t <= MAH_B);
+        int dest  = t + step;
+        int carry = dest >= ADJUST_NOTE;
+        dest -= carry * ADJUST_NOTE;
+
+        invalid |= !valid;
+        out_tone[i] = valid * dest;
+        out_acci[i] = valid * (acci[i] + semi + SEMITONE(t) - SEMITONE(dest) - carry * SIZE_CHROMATIC);
+        out_oct[i]  = valid * (oct[i] + octave + carry);
+    }
+    out->size = size;
+
+    if (invalid)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+    }
+}
+
+void
+mah_return_inter_batch(
+    struct mah_note_batch const* notes_a, struct mah_note_batch const* notes_b, struct mah_interval out[],
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_RETURN_INTER_BATCH);
+
+    int size                     = notes_a->size;
+    enum mah_tone const* tone_a  = notes_a->tone;
+    enum mah_tone const* tone_b  = notes_b->tone;
+    int const* acci_a            = notes_a->acci;
+    int const* acci_b            = notes_b->acci;
+    enum mah_octave const* oct_a = notes_a->octave;
+    enum mah_octave const* oct_b = notes_b->octave;
+
+    int invalid_range = 0;
+    int invalid_qual  = 0;
+    VECTORIZE_LOOP
+    for (int i = 0; i < size; i++)
+    { // bitwise rather than logical operators keep the loop free of branches
+        int ta    = tone_a[i];
+        int tb    = tone_b[i];
+        int inter = (tb + oct_b[i] * ADJUST_NOTE) - (ta + oct_a[i] * ADJUST_NOTE) + 1;
+        int range = (inter > 0) & (ta >= MAH_C) & (ta <= MAH_B) & (tb >= MAH_C) & (tb <= MAH_B);
+        int pitch = oct_b[i] - (inter > SIMPLE_INTER_MAX) * (inter / SIMPLE_INTER_MAX);
+
+        int simple  = tb - ta + (tb < ta) * ADJUST_NOTE;
+        int perfect = (simple == 0) | (simple == 3) | (simple == 4);
+        int diff    = SEMITONE(tb) - SEMITONE(ta) - SEMITONE(simple) + acci_b[i] - acci_a[i] +
+                   (pitch - oct_a[i]) * SIZE_CHROMATIC;
+        int qual = ((diff >= RAW_MIN) & (diff <= 1)) | ((diff >= 11) & (diff < RAW_MIN + RAW_SIZE));
+
+        // same mapping as QUAL_TABLE
+        int wrap  = diff >= 11;
+        int value = diff - wrap * SIZE_CHROMATIC;
+        value += (perfect & (value == 0)) * (MAH_PERFECT - value) + (perfect & (value == -1)) * (MAH_DIMINISHED - value);
+
+        invalid_range |= !range;
+        invalid_qual |= !qual;
+        out[i].steps = (range & qual) * inter;
+        out[i].qual  = (range & qual) * value;
+    }
+
+    if (invalid_range)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+    }
+    else if (invalid_qual)
+    {
+        SET_ERR(MAH_ERROR_INVALID_QUAL);
+    }
 }
\ No newline at end of file
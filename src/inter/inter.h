@@ -27,5 +27,12 @@ typedef struct mah_interval
 
 struct mah_note mah_get_inter(struct mah_note note, struct mah_interval interval, enum mah_error* err);
 struct mah_interval mah_return_inter(struct mah_note note_a, struct mah_note note_b, enum mah_error* err);
+void mah_get_inter_batch(
+    struct mah_note_batch const* notes, struct mah_interval interval, struct mah_note_batch* out, enum mah_error* err
+);
+void mah_return_inter_batch(
+    struct mah_note_batch const* notes_a, struct mah_note_batch const* notes_b, struct mah_interval out[],
+    enum mah_error* err
+);
 
 #endif
\ No newline at end of file
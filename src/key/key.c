@@ -7,6 +7,8 @@ Defines everything related to key signatures
 
 #include "key/key.h"
 #include "inter/inter.h"
+#include "shared/shared.h"
+#include <string.h>
 
 // Macros //
 
@@ -15,9 +17,114 @@ Defines everything related to key signatures
 #define KEY_SHARP_ADJ 1 // Adjust tblKey account for F for sharps
 #define KEY_FLAT_ROOT 6 // Starting point for flats from sharps without F+ at tblKey
 #define KEY_SIG_DIF 3   // Difference of Parallel Major and Minor (G+ = 1, 1 - 3 = -2 = G-)
+#define KEY_TABLE_MAX 14 // Largest alter in KEY_TABLE (both directions)
+
+// Floor of n / 7 and n mod 7 (never negative), for flat keys
+#define FLOOR_SIG(n) ((n) >= 0 ? (n) / KEY_SIG_MAX : -((KEY_SIG_MAX - 1 - (n)) / KEY_SIG_MAX))
+#define MOD_SIG(n) ((n) - KEY_SIG_MAX * FLOOR_SIG(n))
+
+// Accidental of tone t in a key of alter a (F is the 1st sharp, B is the 1st flat)
+#define ACCI_ENTRY(a, t) FLOOR_SIG((a) + KEY_SIG_MAX - 1 - (2 * (t) + 1) % KEY_SIG_MAX)
+#define ACCI_ROW(a)                                                                                                    \
+    {                                                                                                                  \
+        ACCI_ENTRY(a, 0), ACCI_ENTRY(a, 1), ACCI_ENTRY(a, 2), ACCI_ENTRY(a, 3), ACCI_ENTRY(a, 4), ACCI_ENTRY(a, 5),    \
+            ACCI_ENTRY(a, 6),                                                                                          \
+    }
+
+// Note k fifths above F
+#define FIFTH_NOTE(k)                                                                                                  \
+    {                                                                                                                  \
+        .tone = (3 + 4 * MOD_SIG(k)) % KEY_SIG_MAX, .acci = FLOOR_SIG(k)                                               \
+    }
+
+// ith note of the key signature of alter a, same as make_key_sig
+#define SIG_NOTE(a, i)                                                                                                 \
+    {                                                                                                                  \
+        .tone = (a) < 0 ? (6 + 3 * (i)) % KEY_SIG_MAX : (3 + 4 * (i)) % KEY_SIG_MAX,                                   \
+        .acci = (a) / KEY_SIG_MAX + ((a) < 0 ? -((i) < -(a) % KEY_SIG_MAX) : (i) < (a) % KEY_SIG_MAX),                 \
+    }
+
+// Entry of KEY_TABLE for type t and alter a, tonic is a + 1 fifths above F (+3 for minor)
+#define KEY_ENTRY(t, a)                                                                                                \
+    {                                                                                                                  \
+        .type  = (t),                                                                                                  \
+        .alter = (a),                                                                                                  \
+        .size  = (a) > KEY_SIG_MAX || (a) < -KEY_SIG_MAX ? KEY_SIG_MAX : (a) < 0 ? -(a) : (a),                         \
+        .key   = FIFTH_NOTE((a) + 1 + (t) * KEY_SIG_DIF),                                                              \
+        .notes = { SIG_NOTE(a, 0), SIG_NOTE(a, 1), SIG_NOTE(a, 2), SIG_NOTE(a, 3), SIG_NOTE(a, 4), SIG_NOTE(a, 5),     \
+                   SIG_NOTE(a, 6) },                                                                                   \
+    }
+#define KEY_MAJOR(a) KEY_ENTRY(MAH_MAJOR_KEY, a)
+#define KEY_MINOR(a) KEY_ENTRY(MAH_MINOR_KEY, a)
+
+// Expands X for every alter in KEY_TABLE
+#define KEY_ALTERS(X)                                                                                                  \
+    X(-14), X(-13), X(-12), X(-11), X(-10), X(-9), X(-8), X(-7), X(-6), X(-5), X(-4), X(-3), X(-2), X(-1), X(0), X(1), \
+        X(2), X(3), X(4), X(5), X(6), X(7), X(8), X(9), X(10), X(11), X(12), X(13), X(14)
+
+#define IN_KEY_TABLE(alter) ((alter) >= -KEY_TABLE_MAX && (alter) <= KEY_TABLE_MAX)
+
+#define CARRY_OCTAVE_MIN MAH_OCTAVE_NEG5 // Lowest octave tracked for carried accidentals
+#define CARRY_OCTAVE_SIZE 21             // Octaves tracked for carried accidentals (MAH_OCTAVE_NEG5 -> MAH_OCTAVE_15)
+
+// Structures //
+
+struct key_carry
+{ // accidentals written earlier in the measure, by tone and octave
+    int accis[KEY_SIG_MAX];                    // accidental of each tone in the key
+    int const* bars;                           // indices starting each measure
+    int num_bars;                              // size of bars
+    int bar;                                   // bars already passed
+    int measure;                               // current measure, older stamps are from past measures
+    int stamp[KEY_SIG_MAX][CARRY_OCTAVE_SIZE]; // measure an accidental was last written in
+    int acci[KEY_SIG_MAX][CARRY_OCTAVE_SIZE];  // accidental last written
+};
+
+// Global Variables //
+
+static signed char const ACCI_TABLE[2 * KEY_TABLE_MAX + 1][KEY_SIG_MAX] = {
+    // Accidental of every tone, by alter + KEY_TABLE_MAX and tone
+    KEY_ALTERS(ACCI_ROW),
+};
+
+static struct mah_key_sig const KEY_TABLE[2][2 * KEY_TABLE_MAX + 1] = {
+    // Every key signature up to double sharps and flats, by type and alter + KEY_TABLE_MAX
+    { KEY_ALTERS(KEY_MAJOR) },
+    { KEY_ALTERS(KEY_MINOR) },
+};
 
 // Internal Functions //
 
+static int
+key_alter(struct mah_note const key, enum mah_key_type const type)
+{ // alter of the key signature of tonic key
+    static int const table[] = {
+        0, 2, 4, -1, 1, 3, 5, // Major Key Acci Number
+    };
+
+    // +7 is sharp equiv, -7 is flat equiv, ect, minor equiv - 3
+    return table[key.tone] + (KEY_SIG_MAX * key.acci) - (type * KEY_SIG_DIF);
+}
+
+static signed char const*
+key_accis(struct mah_key_sig const* key)
+{ // row of ACCI_TABLE for key->alter, NULL outside the table or when notes were changed by hand
+    if (!IN_KEY_TABLE(key->alter))
+    {
+        return NULL;
+    }
+
+    struct mah_note const* notes = KEY_TABLE[MAH_MAJOR_KEY][key->alter + KEY_TABLE_MAX].notes;
+    for (int i = 0; i < KEY_SIG_MAX; i++)
+    {
+        if (key->notes[i].tone != notes[i].tone || key->notes[i].acci != notes[i].acci)
+        {
+            return NULL;
+        }
+    }
+    return ACCI_TABLE[key->alter + KEY_TABLE_MAX];
+}
+
 static struct mah_key_sig
 make_key_sig(struct mah_note key, int const alter, enum mah_key_type const type)
 {
@@ -57,22 +164,86 @@ make_key_sig(struct mah_note key, int const alter, enum mah_key_type const type)
     return new;
 }
 
+static void
+start_carry(struct key_carry* carry, struct mah_key_sig const* key, int const bars[], int const num_bars)
+{
+    signed char const* accis = key_accis(key);
+    for (int i = 0; i < KEY_SIG_MAX; i++)
+    {
+        carry->accis[i] = accis != NULL ? accis[i] : mah_query_acci(key, (enum mah_tone) i);
+    }
+    carry->bars     = bars;
+    carry->num_bars = bars != NULL ? num_bars : 0;
+    carry->bar      = 0;
+    carry->measure  = 1;
+    memset(carry->stamp, 0, sizeof(carry->stamp));
+}
+
+static inline int
+carry_acci(
+    struct key_carry* carry, int const i, enum mah_tone const tone, int const acci, enum mah_octave const octave,
+    bool const strip, enum mah_error* err
+)
+{ // returns the accidental of note i once the key is applied or stripped
+    while (carry->bar < carry->num_bars && carry->bars[carry->bar] <= i)
+    { // crossed a bar line, forget carried accidentals
+        carry->bar++;
+        carry->measure++;
+    }
+
+    if (tone == MAH_REST)
+    {
+        return acci;
+    }
+    if ((unsigned) tone >= KEY_SIG_MAX || (unsigned) (octave - CARRY_OCTAVE_MIN) >= CARRY_OCTAVE_SIZE)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return acci;
+    }
+
+    int* stamp = &carry->stamp[tone][octave - CARRY_OCTAVE_MIN];
+    int* last  = &carry->acci[tone][octave - CARRY_OCTAVE_MIN];
+    int expect = *stamp == carry->measure ? *last : carry->accis[tone];
+    if (acci == MAH_KEY_ACCI)
+    {
+        return strip ? acci : expect;
+    }
+    if (strip && acci == expect)
+    {
+        return MAH_KEY_ACCI;
+    }
+
+    *stamp = carry->measure;
+    *last  = acci;
+    return acci;
+}
+
 // Functions //
 
 struct mah_key_sig
 mah_get_key_sig(struct mah_note const key, enum mah_key_type const type)
 {
-    static int const table[] = {
-        0, 2, 4, -1, 1, 3, 5, // Major Key Acci Number
-    };
+    PROFILE_CALL(MAH_STATS_GET_KEY_SIG);
 
-    // +7 is sharp equiv, -7 is flat equiv, ect, minor equiv - 3
-    return make_key_sig(key, table[key.tone] + (KEY_SIG_MAX * key.acci) - (type * KEY_SIG_DIF), type);
+    int alter = key_alter(key, type);
+    if (IN_KEY_TABLE(alter))
+    {
+        return KEY_TABLE[type][alter + KEY_TABLE_MAX];
+    }
+
+    return make_key_sig(key, alter, type);
 }
 
 struct mah_key_sig
 mah_get_key_relative(struct mah_key_sig const* key)
 {
+    PROFILE_CALL(MAH_STATS_GET_KEY_RELATIVE);
+
+    if (IN_KEY_TABLE(key->alter))
+    { // relative key shares the alter
+        return KEY_TABLE[key->type == MAH_MINOR_KEY ? MAH_MAJOR_KEY : MAH_MINOR_KEY][key->alter + KEY_TABLE_MAX];
+    }
+
     struct mah_note note = mah_get_inter(
         key->key,
         key->type == MAH_MINOR_KEY ? (struct mah_interval) { .steps = 3, .qual = MAH_MINOR, } :
@@ -86,6 +257,13 @@ mah_get_key_relative(struct mah_key_sig const* key)
 struct mah_key_sig
 mah_return_key_sig(int const alter, enum mah_key_type const type)
 {
+    PROFILE_CALL(MAH_STATS_RETURN_KEY_SIG);
+
+    if (IN_KEY_TABLE(alter))
+    {
+        return KEY_TABLE[type][alter + KEY_TABLE_MAX];
+    }
+
     static enum mah_tone const tbl_key[] = {
         [0] = MAH_F, [1] = MAH_C, [2] = MAH_G, [3] = MAH_D, [4] = MAH_A, [5] = MAH_E, [6] = MAH_B,
     };
@@ -117,6 +295,14 @@ mah_return_key_sig(int const alter, enum mah_key_type const type)
 int
 mah_query_acci(struct mah_key_sig const* key, enum mah_tone const note)
 {
+    PROFILE_CALL(MAH_STATS_QUERY_ACCI);
+
+    signed char const* accis = key_accis(key);
+    if (accis != NULL && (unsigned) note < KEY_SIG_MAX)
+    {
+        return accis[note];
+    }
+
     static int const lkp_sharp[] = {
         // look up table for Circle of 5ths -> indices
         [MAH_F] = 0, [MAH_C] = 1, [MAH_G] = 2, [MAH_D] = 3, [MAH_A] = 4, [MAH_E] = 5, [MAH_B] = 6,
@@ -125,4 +311,110 @@ mah_query_acci(struct mah_key_sig const* key, enum mah_tone const note)
         [MAH_B] = 0, [MAH_E] = 1, [MAH_A] = 2, [MAH_D] = 3, [MAH_G] = 4, [MAH_C] = 5, [MAH_F] = 6,
     };
     return key->notes[key->alter < 0 ? lkp_flat[note] : lkp_sharp[note]].acci;
+}
+
+void
+mah_apply_key_sig_notes(
+    struct mah_note notes[], int const size, int const bars[], int const num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_APPLY_KEY_SIG_NOTES);
+
+    struct key_carry carry;
+    start_carry(&carry, key, bars, num_bars);
+    for (int i = 0; i < size; i++)
+    {
+        notes[i].acci = carry_acci(&carry, i, notes[i].tone, notes[i].acci, notes[i].octave, false, err);
+    }
+}
+
+void
+mah_strip_key_sig_notes(
+    struct mah_note notes[], int const size, int const bars[], int const num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_STRIP_KEY_SIG_NOTES);
+
+    struct key_carry carry;
+    start_carry(&carry, key, bars, num_bars);
+    for (int i = 0; i < size; i++)
+    {
+        notes[i].acci = carry_acci(&carry, i, notes[i].tone, notes[i].acci, notes[i].octave, true, err);
+    }
+}
+
+void
+mah_apply_key_sig_timed_notes(
+    struct mah_timed_note notes[], int const size, int const bars[], int const num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_APPLY_KEY_SIG_TIMED_NOTES);
+
+    struct key_carry carry;
+    start_carry(&carry, key, bars, num_bars);
+    for (int i = 0; i < size; i++)
+    {
+        notes[i].acci_timed =
+            carry_acci(&carry, i, notes[i].tone_timed, notes[i].acci_timed, notes[i].octave_timed, false, err);
+    }
+}
+
+void
+mah_strip_key_sig_timed_notes(
+    struct mah_timed_note notes[], int const size, int const bars[], int const num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_STRIP_KEY_SIG_TIMED_NOTES);
+
+    struct key_carry carry;
+    start_carry(&carry, key, bars, num_bars);
+    for (int i = 0; i < size; i++)
+    {
+        notes[i].acci_timed =
+            carry_acci(&carry, i, notes[i].tone_timed, notes[i].acci_timed, notes[i].octave_timed, true, err);
+    }
+}
+
+void
+mah_apply_key_sig_batch(
+    struct mah_note_batch* notes, int const bars[], int const num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_APPLY_KEY_SIG_BATCH);
+
+    enum mah_tone const* tone     = notes->tone;
+    int* acci                     = notes->acci;
+    enum mah_octave const* octave = notes->octave;
+
+    struct key_carry carry;
+    start_carry(&carry, key, bars, num_bars);
+    for (int i = 0; i < notes->size; i++)
+    {
+        acci[i] = carry_acci(&carry, i, tone[i], acci[i], octave[i], false, err);
+    }
+}
+
+void
+mah_strip_key_sig_batch(
+    struct mah_note_batch* notes, int const bars[], int const num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_STRIP_KEY_SIG_BATCH);
+
+    enum mah_tone const* tone     = notes->tone;
+    int* acci                     = notes->acci;
+    enum mah_octave const* octave = notes->octave;
+
+    struct key_carry carry;
+    start_carry(&carry, key, bars, num_bars);
+    for (int i = 0; i < notes->size; i++)
+    {
+        acci[i] = carry_acci(&carry, i, tone[i], acci[i], octave[i], true, err);
+    }
 }
\ No newline at end of file
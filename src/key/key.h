@@ -1,7 +1,9 @@
 #ifndef __MAH_KEY_H__
 #define __MAH_KEY_H__
 
+#include "err/err.h"
 #include "note/note.h"
+#include <limits.h>
 
 // Enums //
 
@@ -11,6 +13,10 @@ typedef enum mah_key_type
     MAH_MINOR_KEY
 } mah_key_type;
 
+// Macros //
+
+#define MAH_KEY_ACCI INT_MIN // acci of a note with no written accidental, taken from the key
+
 // Structures //
 
 typedef struct mah_key_sig
@@ -29,4 +35,28 @@ struct mah_key_sig mah_return_key_sig(int alter, enum mah_key_type type);
 struct mah_key_sig mah_get_key_relative(struct mah_key_sig const* key);
 int mah_query_acci(struct mah_key_sig const* key, enum mah_tone note);
 
+// In place spelling of note streams, bars are the indices starting each measure
+void mah_apply_key_sig_notes(
+    struct mah_note notes[], int size, int const bars[], int num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+);
+void mah_strip_key_sig_notes(
+    struct mah_note notes[], int size, int const bars[], int num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+);
+void mah_apply_key_sig_timed_notes(
+    struct mah_timed_note notes[], int size, int const bars[], int num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+);
+void mah_strip_key_sig_timed_notes(
+    struct mah_timed_note notes[], int size, int const bars[], int num_bars, struct mah_key_sig const* key,
+    enum mah_error* err
+);
+void mah_apply_key_sig_batch(
+    struct mah_note_batch* notes, int const bars[], int num_bars, struct mah_key_sig const* key, enum mah_error* err
+);
+void mah_strip_key_sig_batch(
+    struct mah_note_batch* notes, int const bars[], int num_bars, struct mah_key_sig const* key, enum mah_error* err
+);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,465 @@
+/*
+
+| midi.c |
+Defines the Standard MIDI File reader and writer
+Reads from and writes to caller memory (eg, a memory mapped file) without copying, allocating or doing I/O
+
+*/
+
+#include "midi/midi.h"
+#include "shared/shared.h"
+#include <string.h>
+
+// Macros //
+
+#define MIDI_CHANNELS 16
+#define MIDI_KEYS 128
+#define MIDI_HEADER 14            // "MThd", length and 6 bytes of header data
+#define MIDI_CHUNK 8              // chunk id and length
+#define MIDI_VARINT_MAX 4         // bytes of the longest variable length quantity
+#define MIDI_DELTA_MAX 0x0FFFFFFF // largest variable length quantity
+#define MIDI_TRACKS_MAX 0xFFFF    // largest track count of the header
+
+#define READ_BE16(p) ((uint32_t) (p)[0] << 8 | (uint32_t) (p)[1])
+#define READ_BE32(p) ((uint32_t) (p)[0] << 24 | (uint32_t) (p)[1] << 16 | (uint32_t) (p)[2] << 8 | (uint32_t) (p)[3])
+
+// Structures //
+
+struct midi_pending
+{ // note on waiting for its note off
+    uint64_t start;
+    int velocity;
+    int live; // 1 if waiting
+};
+
+struct midi_reader
+{ // state shared by the tracks of mah_read_midi_notes
+    struct mah_midi_note* buf;
+    int max;
+    int num;
+    mah_midi_callback callback;
+    void* ctx;
+    int live; // pending notes waiting
+    struct midi_pending pending[MIDI_CHANNELS * MIDI_KEYS];
+};
+
+// Internal Functions //
+
+static struct mah_note
+key_note(int const key)
+{ // MIDI octave mapping of enum mah_octave, key 60 is C4 (spelled with sharps)
+    struct mah_note note = from_semitone(key % SIZE_CHROMATIC);
+    note.octave          = key / SIZE_CHROMATIC - 1;
+    return note;
+}
+
+static bool
+read_varint(unsigned char const** pos, unsigned char const* end, uint32_t* value)
+{ // reads a variable length quantity (7 bits per byte, high bit set on all but the last)
+    unsigned char const* p = *pos;
+    uint32_t sum           = 0;
+    for (int i = 0; i < MIDI_VARINT_MAX && p < end; i++)
+    {
+        unsigned char byte = *p++;
+        sum                = sum << 7 | (byte & 0x7F);
+        if (!(byte & 0x80))
+        {
+            *pos   = p;
+            *value = sum;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+end_note(struct midi_reader* reader, int const slot, uint64_t const tick, int const track)
+{ // pairs the pending note on in slot with its note off at tick
+    struct midi_pending* pending = &reader->pending[slot];
+    pending->live                = 0;
+    reader->live--;
+
+    struct mah_midi_note* note = &reader->buf[reader->num++];
+    note->note                 = key_note(slot % MIDI_KEYS);
+    note->start                = pending->start;
+    note->ticks                = tick - pending->start;
+    note->track                = track;
+    note->channel              = slot / MIDI_KEYS;
+    note->velocity             = pending->velocity;
+    if (reader->num == reader->max)
+    {
+        reader->callback(reader->buf, reader->num, reader->ctx);
+        reader->num = 0;
+    }
+}
+
+static enum mah_error
+read_track(struct midi_reader* reader, unsigned char const* p, unsigned char const* end, int const track)
+{ // walks the events of one track chunk, notes left on at the end of the track end there
+    uint64_t tick   = 0;
+    unsigned status = 0; // running status, 0 if none
+    while (p < end)
+    {
+        uint32_t delta = 0;
+        if (!read_varint(&p, end, &delta) || p == end)
+        {
+            return MAH_ERROR_INVALID_MIDI;
+        }
+        tick += delta;
+
+        unsigned byte = *p;
+        if (byte & 0x80)
+        {
+            p++;
+            status = byte < 0xF0 ? byte : 0; // system messages cancel running status
+        }
+        else if (status == 0)
+        { // data byte with no running status
+            return MAH_ERROR_INVALID_MIDI;
+        }
+        else
+        {
+            byte = status;
+        }
+
+        switch (byte >> 4)
+        {
+        case 0x8:
+        case 0x9:
+        {
+            if (end - p < 2)
+            {
+                return MAH_ERROR_INVALID_MIDI;
+            }
+            int slot     = (int) (byte & 0x0F) * MIDI_KEYS + (p[0] & 0x7F);
+            int velocity = p[1] & 0x7F;
+            p += 2;
+
+            if (reader->pending[slot].live)
+            { // note off, or a repeated note on ending the one before
+                end_note(reader, slot, tick, track);
+            }
+            if ((byte >> 4) == 0x9 && velocity > 0)
+            { // note on with velocity 0 is a note off
+                reader->pending[slot] = (struct midi_pending) { tick, velocity, 1 };
+                reader->live++;
+            }
+            break;
+        }
+        case 0xA:
+        case 0xB:
+        case 0xE:
+            if (end - p < 2)
+            {
+                return MAH_ERROR_INVALID_MIDI;
+            }
+            p += 2;
+            break;
+        case 0xC:
+        case 0xD:
+            if (end - p < 1)
+            {
+                return MAH_ERROR_INVALID_MIDI;
+            }
+            p += 1;
+            break;
+        default:
+        { // meta (0xFF) or sysex (0xF0, 0xF7) events, skipped except for end of track
+            uint32_t len = 0;
+            int type     = -1;
+            if (byte == 0xFF)
+            {
+                if (p == end)
+                {
+                    return MAH_ERROR_INVALID_MIDI;
+                }
+                type = *p++;
+            }
+            else if (byte != 0xF0 && byte != 0xF7)
+            {
+                return MAH_ERROR_INVALID_MIDI;
+            }
+            if (!read_varint(&p, end, &len) || (size_t) (end - p) < len)
+            {
+                return MAH_ERROR_INVALID_MIDI;
+            }
+            p += len;
+            if (type == 0x2F)
+            {
+                p = end;
+            }
+            break;
+        }
+        }
+    }
+
+    for (int slot = 0; reader->live > 0 && slot < MIDI_CHANNELS * MIDI_KEYS; slot++)
+    { // notes with no note off
+        if (reader->pending[slot].live)
+        {
+            end_note(reader, slot, tick, track);
+        }
+    }
+    return MAH_ERROR_NONE;
+}
+
+static size_t
+write_varint(unsigned char out[], uint32_t const value)
+{ // writes value as a variable length quantity to out (if not NULL), returns its bytes
+    size_t len = 1;
+    while (len < MIDI_VARINT_MAX && value >> (7 * len))
+    {
+        len++;
+    }
+    for (size_t i = 0; out != NULL && i < len; i++)
+    {
+        out[i] = (unsigned char) ((value >> (7 * (len - 1 - i))) & 0x7F) | (i + 1 < len ? 0x80 : 0);
+    }
+    return len;
+}
+
+static size_t
+write_event(unsigned char out[], uint32_t const delta, int const status, int const key, int const velocity)
+{ // writes one note on event, with status 0 if running status applies, returns its bytes
+    size_t len = write_varint(out, delta);
+    if (out != NULL)
+    {
+        unsigned char* p = out + len;
+        if (status != 0)
+        {
+            *p++ = (unsigned char) status;
+        }
+        p[0] = (unsigned char) key;
+        p[1] = (unsigned char) velocity;
+    }
+    return len + (status != 0) + 2;
+}
+
+static enum mah_error
+write_track(struct mah_midi_track const* track, unsigned char out[], size_t* size)
+{ // writes the events of track to out, or only counts their bytes if out is NULL
+    size_t len     = 0;
+    uint32_t delta = 0; // ticks since the last event
+    int status     = 0x90 | track->channel;
+    for (int i = 0; i < track->num; i++)
+    {
+        struct mah_timed_note note = track->notes[i];
+        enum mah_error note_err    = MAH_ERROR_NONE;
+        int ticks                  = mah_get_duration_ticks(&note, &note_err);
+        if (note_err != MAH_ERROR_NONE)
+        {
+            return note_err;
+        }
+        if ((uint32_t) ticks > MIDI_DELTA_MAX - delta)
+        {
+            return MAH_ERROR_INVALID_RANGE;
+        }
+        if (note.tone_timed == MAH_REST)
+        {
+            delta += (uint32_t) ticks;
+            continue;
+        }
+
+        struct mah_note pitch = { note.tone_timed, note.acci_timed, note.octave_timed };
+        int key               = mah_get_midi_key(pitch, &note_err);
+        if (note_err != MAH_ERROR_NONE)
+        {
+            return note_err;
+        }
+        // note off is a note on with velocity 0, so every event after the first shares its status
+        len += write_event(out ? out + len : NULL, delta, status, key, track->velocity);
+        len += write_event(out ? out + len : NULL, (uint32_t) ticks, 0, key, 0);
+        status = 0;
+        delta  = 0;
+    }
+
+    len += write_varint(out ? out + len : NULL, delta);
+    if (out != NULL)
+    { // end of track
+        memcpy(out + len, (unsigned char[]) { 0xFF, 0x2F, 0x00 }, 3);
+    }
+    *size = len + 3;
+    return MAH_ERROR_NONE;
+}
+
+static void
+write_be32(unsigned char out[], uint32_t const value)
+{
+    out[0] = (unsigned char) (value >> 24);
+    out[1] = (unsigned char) (value >> 16);
+    out[2] = (unsigned char) (value >> 8);
+    out[3] = (unsigned char) value;
+}
+
+// Functions //
+
+struct mah_midi_file
+mah_read_midi_file(unsigned char const data[], size_t const size, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_READ_MIDI_FILE);
+
+    if (size < MIDI_HEADER || memcmp(data, "MThd", 4) != 0)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_midi_file, MAH_ERROR_INVALID_MIDI);
+    }
+
+    uint32_t len = READ_BE32(data + 4);
+    int format   = (int) READ_BE16(data + 8);
+    int tracks   = (int) READ_BE16(data + 10);
+    int division = (int) (int16_t) READ_BE16(data + 12);
+    if (len < 6 || len > size - MIDI_CHUNK || format > 2 || (format == 0 && tracks != 1) || division == 0)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_midi_file, MAH_ERROR_INVALID_MIDI);
+    }
+
+    return (struct mah_midi_file) {
+        .data     = data,
+        .size     = size,
+        .format   = format,
+        .tracks   = tracks,
+        .division = division,
+    };
+}
+
+void
+mah_read_midi_notes(
+    struct mah_midi_file const* file, struct mah_midi_note buf[], int const max, mah_midi_callback callback, void* ctx,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_READ_MIDI_NOTES);
+
+    if (max <= 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return;
+    }
+
+    struct midi_reader reader = { .buf = buf, .max = max, .callback = callback, .ctx = ctx };
+    unsigned char const* p    = file->data + MIDI_CHUNK + READ_BE32(file->data + 4);
+    unsigned char const* end  = file->data + file->size;
+    int track                 = 0;
+    while (end - p >= MIDI_CHUNK)
+    { // tracks are read in order, other chunks are skipped
+        uint32_t len = READ_BE32(p + 4);
+        if ((size_t) (end - p - MIDI_CHUNK) < len)
+        {
+            SET_ERR(MAH_ERROR_INVALID_MIDI);
+            return;
+        }
+        if (memcmp(p, "MTrk", 4) == 0)
+        {
+            enum mah_error track_err = read_track(&reader, p + MIDI_CHUNK, p + MIDI_CHUNK + len, track++);
+            if (track_err != MAH_ERROR_NONE)
+            {
+                SET_ERR(track_err);
+                return;
+            }
+        }
+        p += MIDI_CHUNK + len;
+    }
+
+    if (reader.num > 0)
+    {
+        callback(buf, reader.num, ctx);
+    }
+}
+
+struct mah_note
+mah_get_midi_note(int const key, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_MIDI_NOTE);
+
+    if (key < 0 || key >= MIDI_KEYS)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_note, MAH_ERROR_INVALID_RANGE);
+    }
+
+    return key_note(key);
+}
+
+void
+mah_write_midi_file(
+    struct mah_midi_track const tracks[], int const num, struct mah_buffer* out, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_WRITE_MIDI_FILE);
+
+    if (num <= 0 || num > MIDI_TRACKS_MAX)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return;
+    }
+
+    size_t size = MIDI_HEADER;
+    for (int t = 0; t < num; t++)
+    { // first pass checks the tracks and counts the bytes of the file
+        size_t len = 0;
+        if (tracks[t].channel < 0 || tracks[t].channel >= MIDI_CHANNELS || tracks[t].velocity <= 0 ||
+            tracks[t].velocity >= MIDI_KEYS || tracks[t].num < 0)
+        {
+            SET_ERR(MAH_ERROR_INVALID_RANGE);
+            return;
+        }
+        enum mah_error track_err = write_track(&tracks[t], NULL, &len);
+        if (track_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(track_err);
+            return;
+        }
+        if (len > UINT32_MAX)
+        {
+            SET_ERR(MAH_ERROR_INVALID_RANGE);
+            return;
+        }
+        size += MIDI_CHUNK + len;
+    }
+
+    out->size = size;
+    if (size > out->max)
+    {
+        unsigned char* data = out->arena ? mah_arena_alloc(out->arena, size, 1, NULL) : NULL;
+        if (data == NULL)
+        {
+            SET_ERR(MAH_ERROR_OVERFLOW_MIDI);
+            return;
+        }
+        out->data = data;
+        out->max  = size;
+    }
+
+    // second pass writes the whole file, format 1 (parallel tracks) unless there is one track
+    unsigned char* p = out->data;
+    memcpy(p, "MThd", 4);
+    write_be32(p + 4, MIDI_HEADER - MIDI_CHUNK);
+    p[8]  = 0;
+    p[9]  = num > 1;
+    p[10] = (unsigned char) (num >> 8);
+    p[11] = (unsigned char) num;
+    p[12] = MAH_MIDI_DIVISION >> 8;
+    p[13] = MAH_MIDI_DIVISION & 0xFF;
+    p += MIDI_HEADER;
+    for (int t = 0; t < num; t++)
+    {
+        size_t len = 0;
+        write_track(&tracks[t], p + MIDI_CHUNK, &len);
+        memcpy(p, "MTrk", 4);
+        write_be32(p + 4, (uint32_t) len);
+        p += MIDI_CHUNK + len;
+    }
+}
+
+int
+mah_get_midi_key(struct mah_note const note, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_MIDI_KEY);
+
+    // 64 bits so no octave or accidental overflows before the range check
+    int64_t key = SEMITONE(note.tone) + (int64_t) note.acci + ((int64_t) note.octave + 1) * SIZE_CHROMATIC;
+    if (note.tone < MAH_C || note.tone > MAH_B || key < 0 || key >= MIDI_KEYS)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return 0;
+    }
+    return (int) key;
+}
@@ -0,0 +1,61 @@
+#ifndef __MAH_MIDI_H__
+#define __MAH_MIDI_H__
+
+#include "arena/arena.h"
+#include "err/err.h"
+#include "note/note.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Macros //
+
+#define MAH_MIDI_DIVISION 480 // ticks per quarter note written by mah_write_midi_file (as in mah_get_duration_ticks)
+
+// Structures //
+
+typedef struct mah_midi_file
+{
+    unsigned char const* data; // whole file, not copied
+    size_t size;               // bytes in data
+    int format;                // 0 (single track), 1 (parallel tracks) or 2 (independent tracks)
+    int tracks;                // track chunks in header
+    int division;              // ticks per quarter note (SMPTE timing if negative)
+} mah_midi_file;
+
+typedef struct mah_midi_note
+{
+    struct mah_note note;
+    uint64_t start; // absolute ticks from start of track
+    uint64_t ticks; // ticks from note on to note off
+    int track;
+    int channel;
+    int velocity;
+} mah_midi_note;
+
+typedef struct mah_midi_track
+{
+    struct mah_timed_note const* notes; // played one after another, MAH_REST for silence
+    int num;                            // notes in notes
+    int channel;                        // 0 -> 15
+    int velocity;                       // 1 -> 127
+} mah_midi_track;
+
+// Types //
+
+// Receives num notes read by mah_read_midi_notes, which are only valid during the call
+typedef void (*mah_midi_callback)(struct mah_midi_note const notes[], int num, void* ctx);
+
+// Functions //
+
+struct mah_midi_file mah_read_midi_file(unsigned char const data[], size_t size, enum mah_error* err);
+void mah_read_midi_notes(
+    struct mah_midi_file const* file, struct mah_midi_note buf[], int max, mah_midi_callback callback, void* ctx,
+    enum mah_error* err
+);
+struct mah_note mah_get_midi_note(int key, enum mah_error* err);
+void mah_write_midi_file(
+    struct mah_midi_track const tracks[], int num, struct mah_buffer* out, enum mah_error* err
+);
+int mah_get_midi_key(struct mah_note note, enum mah_error* err);
+
+#endif
@@ -7,40 +7,266 @@ Defines the functions for general use (not related to chords, scales, ect)
 
 #include "misc/misc.h"
 #include "shared/shared.h"
-#include <stdio.h>
+#include <limits.h>
+#include <string.h>
+
+// Macros //
+
+#define NOTE_TEXT_MAX 17 // note (1) + max acci (4) + sign and digits of any octave (11) + null terminating (1)
+
+// Internal Functions //
+
+static size_t
+format_note(struct mah_note const note, char out[])
+{ // same text as "%c%s%d" without null terminating, out must hold NOTE_TEXT_MAX - 1 chars
+    size_t len = write_pitch(note, out);
+
+    unsigned octave = (unsigned) note.octave;
+    if (note.octave < 0)
+    {
+        out[len++] = '-';
+        octave     = 0u - octave;
+    }
+    if (octave < 10)
+    { // every octave in enum mah_octave
+        out[len++] = (char) ('0' + octave);
+        return len;
+    }
+    if (octave < 100)
+    {
+        out[len++] = (char) ('0' + octave / 10);
+        out[len++] = (char) ('0' + octave % 10);
+        return len;
+    }
+
+    char digits[10];
+    int num = 0;
+    while (octave > 0)
+    {
+        digits[num++] = (char) ('0' + octave % 10);
+        octave /= 10;
+    }
+    while (num > 0)
+    {
+        out[len++] = digits[--num];
+    }
+    return len;
+}
+
+static size_t
+parse_note(char const text[], size_t const len, struct mah_note* note)
+{ // inverse of format_note, returns bytes read or 0 if text does not start with a note
+    size_t pos = read_pitch(text, len, note);
+    if (pos == 0)
+    {
+        return 0;
+    }
+
+    bool neg = pos < len && text[pos] == '-';
+    pos += neg;
+    size_t first     = pos;
+    long long octave = 0;
+    while (pos < len && text[pos] >= '0' && text[pos] <= '9' && pos - first < 11)
+    { // 11 digits is past every int, so the range check below catches it
+        octave = octave * 10 + (text[pos++] - '0');
+    }
+    octave = neg ? -octave : octave;
+    if (pos == first || octave < INT_MIN || octave > INT_MAX || (pos < len && text[pos] >= '0' && text[pos] <= '9'))
+    {
+        return 0;
+    }
+    note->octave = (enum mah_octave) octave;
+    return pos;
+}
 
 // Functions //
 
 char*
 mah_write_note(struct mah_note const note, char buf[], size_t const size, enum mah_error* err)
 {
-    static char const* disp_note         = "CDEFGAB";
-    static char const* const disp_acci[] = {
-        "bbbb", "bbb", "bb", "b", "", "#", "##", "###", "####",
-    };
-
-    if (note.acci < -4 || note.acci > 4)
-    { // dispAccidental limit
-        SET_ERR(MAH_ERROR_INVALID_PRINT_QUAL);
+    PROFILE(MAH_STATS_WRITE_NOTE);
+
+    enum mah_error note_err = check_print_note(note);
+    if (note_err != MAH_ERROR_NONE)
+    {
+        SET_ERR(note_err);
         return "";
     }
 
-    if (note.tone < MAH_C || note.tone > MAH_B)
+    if (size >= NOTE_TEXT_MAX)
+    { // always fits, so skip the copy
+        buf[format_note(note, buf)] = '\0';
+        return buf;
+    }
+
+    char text[NOTE_TEXT_MAX];
+    size_t len = format_note(note, text);
+    if (size > 0)
+    { // truncated like snprintf
+        size_t copy = len < size ? len : size - 1;
+        memcpy(buf, text, copy);
+        buf[copy] = '\0';
+    }
+    if (len >= size)
     {
-        SET_ERR(MAH_ERROR_INVALID_PRINT_NOTE);
-        return "";
+        SET_ERR(MAH_ERROR_OVERFLOW_PRINT_NOTE);
     }
+    return buf;
+}
+
+char*
+mah_write_notes(
+    struct mah_note const notes[], int const num, char buf[], size_t const size, char const* sep, int offsets[],
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_WRITE_NOTES);
 
-    if (!(snprintf(buf, size, "%c%s%d", disp_note[note.tone], disp_acci[note.acci + 4], note.octave) < size))
+    if (size == 0)
     {
         SET_ERR(MAH_ERROR_OVERFLOW_PRINT_NOTE);
+        return buf;
+    }
+
+    size_t sep_len = sep ? strlen(sep) : 0;
+    size_t used    = 0;
+    for (int i = 0; i < num; i++)
+    {
+        enum mah_error note_err = check_print_note(notes[i]);
+        if (note_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(note_err);
+            buf[used] = '\0';
+            return buf;
+        }
+
+        size_t start = i > 0 ? used + sep_len : used;
+        size_t len   = 0;
+        if (start < size && size - start >= NOTE_TEXT_MAX)
+        { // always fits, write in place
+            len = format_note(notes[i], buf + start);
+        }
+        else
+        {
+            char text[NOTE_TEXT_MAX];
+            len = format_note(notes[i], text);
+            if (start + len >= size)
+            { // keep whole notes only
+                SET_ERR(MAH_ERROR_OVERFLOW_PRINT_NOTE);
+                buf[used] = '\0';
+                return buf;
+            }
+            memcpy(buf + start, text, len);
+        }
+
+        if (start > used)
+        {
+            memcpy(buf + used, sep, sep_len);
+        }
+        if (offsets != NULL)
+        {
+            offsets[i] = (int) start;
+        }
+        used = start + len;
+    }
+
+    if (offsets != NULL)
+    {
+        offsets[num] = (int) used;
     }
+    buf[used] = '\0';
     return buf;
 }
 
+struct mah_note
+mah_read_note(char const text[], size_t const len, size_t* read, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_READ_NOTE);
+
+    struct mah_note note = { MAH_C, 0, MAH_OCTAVE_0 };
+    size_t used          = parse_note(text, len, &note);
+    if (read != NULL)
+    {
+        *read = used;
+    }
+    if (used == 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_READ_NOTE);
+        return (struct mah_note) { MAH_C, 0, MAH_OCTAVE_0 };
+    }
+    return note;
+}
+
+int
+mah_read_notes(
+    char const text[], size_t const len, struct mah_note notes[], int const max, size_t* read, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_READ_NOTES);
+
+    int num     = 0;
+    size_t pos  = 0;
+    size_t done = 0; // end of last note read
+    while (true)
+    {
+        while (pos < len && is_text_sep(text[pos]))
+        {
+            pos++;
+        }
+        if (pos == len)
+        {
+            break;
+        }
+        if (num == max)
+        {
+            SET_ERR(MAH_ERROR_OVERFLOW_READ_NOTE);
+            break;
+        }
+
+        size_t used = parse_note(text + pos, len - pos, &notes[num]);
+        if (used == 0 || (pos + used < len && !is_text_sep(text[pos + used])))
+        { // notes must be split by separators
+            SET_ERR(MAH_ERROR_INVALID_READ_NOTE);
+            break;
+        }
+        num++;
+        pos += used;
+        done = pos;
+    }
+
+    if (read != NULL)
+    {
+        *read = done;
+    }
+    return num;
+}
+
 bool
 mah_is_enharmonic(struct mah_note const note_a, struct mah_note const note_b)
 {
+    PROFILE_CALL(MAH_STATS_IS_ENHARMONIC);
+
     return (to_semitone(note_a.tone) + note_a.acci + note_a.octave * SIZE_CHROMATIC) ==
            (to_semitone(note_b.tone) + note_b.acci + note_b.octave * SIZE_CHROMATIC);
+}
+
+void
+mah_is_enharmonic_batch(struct mah_note_batch const* notes_a, struct mah_note_batch const* notes_b, bool out[])
+{
+    PROFILE_CALL(MAH_STATS_IS_ENHARMONIC_BATCH);
+
+    int size                     = notes_a->size;
+    enum mah_tone const* tone_a  = notes_a->tone;
+    enum mah_tone const* tone_b  = notes_b->tone;
+    int const* acci_a            = notes_a->acci;
+    int const* acci_b            = notes_b->acci;
+    enum mah_octave const* oct_a = notes_a->octave;
+    enum mah_octave const* oct_b = notes_b->octave;
+
+    VECTORIZE_LOOP
+    for (int i = 0; i < size; i++)
+    {
+        out[i] = (SEMITONE(tone_a[i]) + acci_a[i] + oct_a[i] * SIZE_CHROMATIC) ==
+                 (SEMITONE(tone_b[i]) + acci_b[i] + oct_b[i] * SIZE_CHROMATIC);
+    }
 }
\ No newline at end of file
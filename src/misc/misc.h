@@ -6,6 +6,14 @@
 #include <stdbool.h>
 
 char* mah_write_note(struct mah_note note, char buf[], size_t size, enum mah_error* err);
+char* mah_write_notes(
+    struct mah_note const notes[], int num, char buf[], size_t size, char const* sep, int offsets[], enum mah_error* err
+);
+struct mah_note mah_read_note(char const text[], size_t len, size_t* read, enum mah_error* err);
+int mah_read_notes(
+    char const text[], size_t len, struct mah_note notes[], int max, size_t* read, enum mah_error* err
+);
 bool mah_is_enharmonic(struct mah_note note_a, struct mah_note note_b);
+void mah_is_enharmonic_batch(struct mah_note_batch const* notes_a, struct mah_note_batch const* notes_b, bool out[]);
 
 #endif
\ No newline at end of file
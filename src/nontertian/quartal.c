@@ -20,6 +20,8 @@ mah_get_quartal_chord(
     enum mah_error* err
 )
 {
+    PROFILE(MAH_STATS_GET_QUARTAL_CHORD);
+
     // Validate num_notes is between 2-5 inclusive
     if (num_notes < 2 || num_notes > 5)
     {
@@ -64,6 +66,8 @@ mah_invert_nontertian_chord(
     enum mah_error* err
 )
 {
+    PROFILE(MAH_STATS_INVERT_NONTERTIAN_CHORD);
+
     if (chord == NULL)
     {
         SET_ERR(MAH_ERROR_INVALID_RANGE);
@@ -125,6 +129,8 @@ mah_fold_nontertian_chord(
     enum mah_error* err
 )
 {
+    PROFILE(MAH_STATS_FOLD_NONTERTIAN_CHORD);
+
     if (chord == NULL)
     {
         SET_ERR(MAH_ERROR_INVALID_RANGE);
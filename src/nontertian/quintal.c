@@ -19,6 +19,8 @@ mah_get_quintal_chord(
     enum mah_error* err
 )
 {
+    PROFILE(MAH_STATS_GET_QUINTAL_CHORD);
+
     // Validate num_notes is between 2-5 inclusive
     if (num_notes < 2 || num_notes > 5)
     {
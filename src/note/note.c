@@ -7,6 +7,7 @@ Provides duration calculations, tuplet support, and measure validation
 */
 
 #include "note/note.h"
+#include "shared/shared.h"
 #include <stddef.h>
 
 // Duration calculation functions //
@@ -14,6 +15,8 @@ Provides duration calculations, tuplet support, and measure validation
 void
 mah_get_duration_fraction(struct mah_timed_note* note, int* numerator, int* denominator, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_GET_DURATION_FRACTION);
+
     if (!note || !numerator || !denominator || !err) {
         if (err) *err = MAH_ERROR_INVALID_DURATION;
         return;
@@ -54,30 +57,19 @@ mah_get_duration_fraction(struct mah_timed_note* note, int* numerator, int* deno
     }
 
     // Standard durations as fractions of whole note
-    switch (note->duration) {
-        case MAH_DOTTED_WHOLE:    *numerator = 3; *denominator = 2; break;
-        case MAH_WHOLE:           *numerator = 1; *denominator = 1; break;
-        case MAH_DOTTED_HALF:     *numerator = 3; *denominator = 4; break;
-        case MAH_HALF:            *numerator = 1; *denominator = 2; break;
-        case MAH_DOTTED_QUARTER:  *numerator = 3; *denominator = 8; break;
-        case MAH_QUARTER:         *numerator = 1; *denominator = 4; break;
-        case MAH_DOTTED_EIGHTH:   *numerator = 3; *denominator = 16; break;
-        case MAH_EIGHTH:          *numerator = 1; *denominator = 8; break;
-        case MAH_DOTTED_SIXTEENTH: *numerator = 3; *denominator = 32; break;
-        case MAH_SIXTEENTH:       *numerator = 1; *denominator = 16; break;
-        case MAH_DOTTED_THIRTYSECOND: *numerator = 3; *denominator = 64; break;
-        case MAH_THIRTYSECOND:    *numerator = 1; *denominator = 32; break;
-        case MAH_SIXTYFOURTH:     *numerator = 1; *denominator = 64; break;
-        case MAH_ONETWENTYEIGHTH: *numerator = 1; *denominator = 128; break;
-        default:
-            *err = MAH_ERROR_INVALID_DURATION;
-            return;
+    if (note->duration < MAH_DOTTED_WHOLE || note->duration >= MAH_TUPLET) {
+        *err = MAH_ERROR_INVALID_DURATION;
+        return;
     }
+    *numerator = DUR_NUM[note->duration];
+    *denominator = 1 << DUR_SHIFT[note->duration];
 }
 
 int
 mah_get_duration_ticks(struct mah_timed_note* note, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_GET_DURATION_TICKS);
+
     if (!note || !err) {
         if (err) *err = MAH_ERROR_INVALID_DURATION;
         return 0;
@@ -87,14 +79,16 @@ mah_get_duration_ticks(struct mah_timed_note* note, enum mah_error* err)
     mah_get_duration_fraction(note, &numerator, &denominator, err);
     if (*err != MAH_ERROR_NONE) return 0;
 
-    // Calculate ticks: (1920 * numerator) / denominator
-    // 1920 is standard MIDI ticks per whole note
-    return (1920 * numerator) / denominator;
+    // Calculate ticks: (WHOLE_TICKS * numerator) / denominator
+    // WHOLE_TICKS is standard MIDI ticks per whole note
+    return (WHOLE_TICKS * numerator) / denominator;
 }
 
 int
 mah_compare_durations(struct mah_timed_note* a, struct mah_timed_note* b, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_COMPARE_DURATIONS);
+
     if (!a || !b || !err) {
         if (err) *err = MAH_ERROR_INVALID_DURATION;
         return 0;
@@ -116,6 +110,8 @@ mah_compare_durations(struct mah_timed_note* a, struct mah_timed_note* b, enum m
 struct mah_tuplet
 mah_create_tuplet(int n, int m, enum mah_dur base, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_CREATE_TUPLET);
+
     struct mah_tuplet tuplet = {0, 0, MAH_QUARTER};
     
     if (!err) return tuplet;
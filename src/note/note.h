@@ -73,6 +73,10 @@ typedef enum mah_dur
     MAH_TUPLET
 } mah_dur;
 
+// Macros //
+
+#define MAH_BATCH_ALIGN 32 // recommended alignment (in bytes) of mah_note_batch arrays
+
 // Structures //
 
 typedef struct mah_tuplet
@@ -90,6 +94,14 @@ typedef struct mah_note
     enum mah_octave octave;
 } mah_note;
 
+typedef struct mah_note_batch
+{
+    enum mah_tone* tone;
+    int* acci;
+    enum mah_octave* octave;
+    int size;
+} mah_note_batch;
+
 typedef struct mah_timed_note
 {
     enum mah_tone tone_timed;
@@ -0,0 +1,543 @@
+/*
+
+| pack.c |
+Defines the packed note representations
+mah_note16 holds tone (3 bits), acci (4 bits) and octave (5 bits) as two's complement, so 0 is an empty mah_note
+mah_timed_note32 adds duration (4 bits) and tuplet index (12 bits, 0 for no tuplet)
+Note streams hold each mah_timed_note as a token byte followed by up to 4 optional fields :
+    token : key delta (5 bits, zigzag, 31 if a varint follows), acci (2 bits : 0, 1, -1 or varint follows),
+            same duration and tuplet as the last note (1 bit)
+    then a varint of key delta + 1 (0 for a rest), a varint of acci, a duration byte and a varint of tuplet index
+
+*/
+
+#include "pack/pack.h"
+#include "shared/shared.h"
+#include <limits.h>
+#include <string.h>
+
+// Macros //
+
+#define TONE_SHIFT 0
+#define ACCI_SHIFT 3
+#define OCTAVE_SHIFT 7
+#define DUR_SHIFT 16
+#define TUPLET_SHIFT 20
+
+#define TONE_MASK 0x7
+#define ACCI_MASK 0xF
+#define OCTAVE_MASK 0x1F
+#define DUR_MASK 0xF
+#define NOTE_MASK 0xFFFF
+
+#define OCTAVE_MIN MAH_OCTAVE_NEG5
+#define OCTAVE_MAX MAH_OCTAVE_15
+
+#define STREAM_KEY_MASK 0x1F   // token bits of key delta
+#define STREAM_KEY_VARINT 0x1F // key delta (or rest) follows as a varint
+#define STREAM_ACCI_SHIFT 5
+#define STREAM_ACCI_MASK 0x3
+#define STREAM_ACCI_VARINT 3   // acci follows as a varint
+#define STREAM_SAME_DUR 0x80   // duration and tuplet of the last note
+#define VARINT_MAX 5           // bytes of the longest 32 bit varint
+
+// Maps signed n to unsigned so that small magnitudes stay small (0, -1, 1, -2 -> 0, 1, 2, 3)
+#define ZIGZAG(n) (((uint32_t) (n) << 1) ^ (0u - ((uint32_t) (n) >> 31)))
+#define UNZIGZAG(u) ((int) (((u) >> 1) ^ (0u - ((u) & 1))))
+
+// True if 64 bit n fits int, so stream keys and their deltas are computed without overflow
+#define IN_INT(n) ((n) >= INT_MIN && (n) <= INT_MAX)
+
+// Sign extends the field of width mask (mask + 1 must be a power of 2)
+#define SIGN_EXTEND(field, mask) ((int) (((field) ^ (((mask) + 1) >> 1)) - (((mask) + 1) >> 1)))
+
+// True if note fields fit in mah_note16
+#define IS_PACKABLE(tone, acci, octave)                                                                                \
+    (((tone) >= MAH_REST) & ((tone) <= MAH_B) & ((acci) >= MAH_PACK_ACCI_MIN) & ((acci) <= MAH_PACK_ACCI_MAX) &        \
+     ((octave) >= OCTAVE_MIN) & ((octave) <= OCTAVE_MAX))
+
+// Packs note fields (must be packable)
+#define PACK_NOTE(tone, acci, octave)                                                                                  \
+    ((mah_note16) ((((unsigned) (tone) & TONE_MASK) << TONE_SHIFT) | (((unsigned) (acci) & ACCI_MASK) << ACCI_SHIFT) |  \
+                   (((unsigned) (octave) & OCTAVE_MASK) << OCTAVE_SHIFT)))
+
+#define UNPACK_TONE(packed) ((int) ((((packed) >> TONE_SHIFT) + 1) & TONE_MASK) - 1) // 7 wraps to MAH_REST
+#define UNPACK_ACCI(packed) SIGN_EXTEND(((packed) >> ACCI_SHIFT) & ACCI_MASK, ACCI_MASK)
+#define UNPACK_OCTAVE(packed) SIGN_EXTEND(((packed) >> OCTAVE_SHIFT) & OCTAVE_MASK, OCTAVE_MASK)
+
+// Global Variables //
+
+static int const NATURAL_TONE[SIZE_CHROMATIC] = { MAH_C, -1, MAH_D, -1, MAH_E, MAH_F, -1, MAH_G, -1, MAH_A, -1, MAH_B };
+
+// Internal Functions //
+
+static size_t
+put_varint(unsigned char out[], uint32_t value)
+{ // writes value 7 bits at a time (lowest first), with the high bit set on all but the last byte
+    size_t len = 0;
+    while (value >= 0x80)
+    {
+        out[len++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (unsigned char) value;
+    return len;
+}
+
+static int
+get_varint(unsigned char const* p, unsigned char const* end, uint32_t* value)
+{ // reads a varint of put_varint, returns its bytes, 0 if cut off by end or -1 if too long
+    uint32_t sum = 0;
+    for (int i = 0; i < VARINT_MAX; i++)
+    {
+        if (p + i == end)
+        {
+            return 0;
+        }
+        if (i == VARINT_MAX - 1 && p[i] > 0x0F)
+        { // last byte only has the top 4 bits of 32
+            return -1;
+        }
+        sum |= (uint32_t) (p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80))
+        {
+            *value = sum;
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+static size_t
+encode_note(
+    struct mah_note_stream* stream, struct mah_timed_note const* note, unsigned char out[],
+    struct mah_tuplet_table* table, enum mah_error* err
+)
+{ // writes note to out (room for MAH_NOTE_STREAM_MAX bytes) and updates stream, returns its bytes (0 on error)
+    if (note->tone_timed < MAH_REST || note->tone_timed > MAH_B)
+    {
+        SET_ERR(MAH_ERROR_INVALID_PACK_NOTE);
+        return 0;
+    }
+    if (note->duration < MAH_DOTTED_WHOLE || note->duration > MAH_TUPLET)
+    {
+        SET_ERR(MAH_ERROR_INVALID_DURATION);
+        return 0;
+    }
+    int tuplet = note->duration == MAH_TUPLET ? find_tuplet(table, note->tuplet, err) : 0;
+    if (note->duration == MAH_TUPLET && tuplet == 0)
+    {
+        return 0;
+    }
+
+    size_t len     = 1;
+    unsigned token = STREAM_KEY_VARINT;
+    if (note->tone_timed == MAH_REST)
+    {
+        out[len++] = 0;
+    }
+    else
+    {
+        int acci    = note->acci_timed;
+        int64_t key = SEMITONE(note->tone_timed) + (int64_t) acci + ((int64_t) note->octave_timed + 1) * SIZE_CHROMATIC;
+        if (!IN_INT(key) || !IN_INT(key - stream->key) || key - stream->key == INT_MIN)
+        { // INT_MIN zigzags to UINT32_MAX, which would wrap to the rest marker once 1 is added
+            SET_ERR(MAH_ERROR_INVALID_PACK_NOTE);
+            return 0;
+        }
+        uint32_t delta = ZIGZAG((int) (key - stream->key));
+        unsigned code  = acci == 0 ? 0 : acci == 1 ? 1 : acci == -1 ? 2 : STREAM_ACCI_VARINT;
+        if (delta < STREAM_KEY_VARINT)
+        {
+            token = delta;
+        }
+        else
+        {
+            len += put_varint(out + len, delta + 1);
+        }
+        if (code == STREAM_ACCI_VARINT)
+        {
+            len += put_varint(out + len, ZIGZAG(acci));
+        }
+        token |= code << STREAM_ACCI_SHIFT;
+        stream->key = (int) key;
+    }
+
+    if (note->duration == stream->duration && tuplet == stream->tuplet)
+    {
+        token |= STREAM_SAME_DUR;
+    }
+    else
+    {
+        out[len++] = (unsigned char) note->duration;
+        if (tuplet > 0)
+        {
+            len += put_varint(out + len, (uint32_t) tuplet);
+        }
+        stream->duration = note->duration;
+        stream->tuplet   = tuplet;
+    }
+    out[0] = (unsigned char) token;
+    return len;
+}
+
+static int
+decode_note(
+    struct mah_note_stream* stream, unsigned char const* p, unsigned char const* end, struct mah_timed_note* note,
+    struct mah_tuplet_table const* table
+)
+{ // reads one note at p (before end) and updates stream, returns its bytes, 0 if cut off by end or -1 if invalid
+    unsigned char const* start = p;
+    unsigned token             = *p++;
+    int64_t key                = stream->key; // 64 bits so deltas of a corrupt stream cannot overflow
+    int code                   = (token >> STREAM_ACCI_SHIFT) & STREAM_ACCI_MASK;
+    int acci                   = (code == 1) - (code == 2);
+    bool rest                  = false;
+    uint32_t value             = 0;
+    int len                    = 0;
+
+    if ((token & STREAM_KEY_MASK) == STREAM_KEY_VARINT)
+    {
+        if ((len = get_varint(p, end, &value)) <= 0)
+        {
+            return len;
+        }
+        p += len;
+        rest = value == 0;
+        key += rest ? 0 : UNZIGZAG(value - 1);
+    }
+    else
+    {
+        key += UNZIGZAG(token & STREAM_KEY_MASK);
+    }
+    if (code == STREAM_ACCI_VARINT)
+    {
+        if ((len = get_varint(p, end, &value)) <= 0)
+        {
+            return len;
+        }
+        p += len;
+        acci = UNZIGZAG(value);
+    }
+
+    enum mah_dur duration = stream->duration;
+    int tuplet            = stream->tuplet;
+    if (!(token & STREAM_SAME_DUR))
+    {
+        if (p == end)
+        {
+            return 0;
+        }
+        duration = *p++;
+        tuplet   = 0;
+        if (duration > MAH_TUPLET)
+        {
+            return -1;
+        }
+        if (duration == MAH_TUPLET)
+        {
+            if ((len = get_varint(p, end, &value)) <= 0)
+            {
+                return len;
+            }
+            p += len;
+            if (value == 0 || table == NULL || value > (uint32_t) table->size)
+            {
+                return -1;
+            }
+            tuplet = (int) value;
+        }
+    }
+
+    struct mah_tuplet* ref = tuplet > 0 ? table->tuplets + tuplet - 1 : NULL;
+    *note                  = (struct mah_timed_note) { MAH_REST, 0, MAH_OCTAVE_0, duration, ref };
+    if (!rest)
+    { // spelling is the natural at key - acci
+        int64_t letter = key - acci;
+        if (!IN_INT(key) || !IN_INT(letter))
+        {
+            return -1;
+        }
+        int semi = constrain_semitone((int) letter);
+        if (NATURAL_TONE[semi] < 0)
+        {
+            return -1;
+        }
+        note->tone_timed   = NATURAL_TONE[semi];
+        note->acci_timed   = acci;
+        note->octave_timed = (int) ((letter - semi) / SIZE_CHROMATIC - 1);
+    }
+    else if (code != 0)
+    {
+        return -1;
+    }
+
+    stream->key      = (int) key;
+    stream->duration = duration;
+    stream->tuplet   = tuplet;
+    return (int) (p - start);
+}
+
+// Functions //
+
+mah_note16
+mah_pack_note(struct mah_note const note, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_PACK_NOTE);
+
+    if (!IS_PACKABLE(note.tone, note.acci, note.octave))
+    {
+        SET_ERR(MAH_ERROR_INVALID_PACK_NOTE);
+        return 0;
+    }
+
+    return PACK_NOTE(note.tone, note.acci, note.octave);
+}
+
+struct mah_note
+mah_unpack_note(mah_note16 const packed)
+{
+    PROFILE_CALL(MAH_STATS_UNPACK_NOTE);
+
+    return (struct mah_note) {
+        .tone   = UNPACK_TONE(packed),
+        .acci   = UNPACK_ACCI(packed),
+        .octave = UNPACK_OCTAVE(packed),
+    };
+}
+
+void
+mah_pack_notes(struct mah_note const notes[], mah_note16 out[], int const size, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_PACK_NOTES);
+
+    int invalid = 0;
+    VECTORIZE_LOOP
+    for (int i = 0; i < size; i++)
+    {
+        int valid = IS_PACKABLE(notes[i].tone, notes[i].acci, notes[i].octave);
+        invalid |= !valid;
+        out[i] = valid * PACK_NOTE(notes[i].tone, notes[i].acci, notes[i].octave);
+    }
+
+    if (invalid)
+    {
+        SET_ERR(MAH_ERROR_INVALID_PACK_NOTE);
+    }
+}
+
+void
+mah_unpack_notes(mah_note16 const packed[], struct mah_note out[], int const size)
+{
+    PROFILE_CALL(MAH_STATS_UNPACK_NOTES);
+
+    VECTORIZE_LOOP
+    for (int i = 0; i < size; i++)
+    {
+        out[i] = (struct mah_note) { UNPACK_TONE(packed[i]), UNPACK_ACCI(packed[i]), UNPACK_OCTAVE(packed[i]) };
+    }
+}
+
+void
+mah_pack_note_batch(struct mah_note_batch const* notes, mah_note16 out[], enum mah_error* err)
+{
+    PROFILE(MAH_STATS_PACK_NOTE_BATCH);
+
+    int size                   = notes->size;
+    enum mah_tone const* tone  = notes->tone;
+    int const* acci            = notes->acci;
+    enum mah_octave const* oct = notes->octave;
+
+    int invalid = 0;
+    VECTORIZE_LOOP
+    for (int i = 0; i < size; i++)
+    {
+        int valid = IS_PACKABLE(tone[i], acci[i], oct[i]);
+        invalid |= !valid;
+        out[i] = valid * PACK_NOTE(tone[i], acci[i], oct[i]);
+    }
+
+    if (invalid)
+    {
+        SET_ERR(MAH_ERROR_INVALID_PACK_NOTE);
+    }
+}
+
+void
+mah_unpack_note_batch(mah_note16 const packed[], int const size, struct mah_note_batch* out)
+{
+    PROFILE_CALL(MAH_STATS_UNPACK_NOTE_BATCH);
+
+    enum mah_tone* tone  = out->tone;
+    int* acci            = out->acci;
+    enum mah_octave* oct = out->octave;
+
+    VECTORIZE_LOOP
+    for (int i = 0; i < size; i++)
+    {
+        tone[i] = UNPACK_TONE(packed[i]);
+        acci[i] = UNPACK_ACCI(packed[i]);
+        oct[i]  = UNPACK_OCTAVE(packed[i]);
+    }
+    out->size = size;
+}
+
+mah_timed_note32
+mah_pack_timed_note(struct mah_timed_note const* note, struct mah_tuplet_table* table, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_PACK_TIMED_NOTE);
+
+    if (!IS_PACKABLE(note->tone_timed, note->acci_timed, note->octave_timed))
+    {
+        SET_ERR(MAH_ERROR_INVALID_PACK_NOTE);
+        return 0;
+    }
+    if (note->duration < MAH_DOTTED_WHOLE || note->duration > MAH_TUPLET)
+    {
+        SET_ERR(MAH_ERROR_INVALID_DURATION);
+        return 0;
+    }
+
+    int index = note->duration == MAH_TUPLET ? find_tuplet(table, note->tuplet, err) : 0;
+    if (note->duration == MAH_TUPLET && index == 0)
+    {
+        return 0;
+    }
+
+    return (mah_timed_note32) PACK_NOTE(note->tone_timed, note->acci_timed, note->octave_timed) |
+           ((mah_timed_note32) note->duration << DUR_SHIFT) | ((mah_timed_note32) index << TUPLET_SHIFT);
+}
+
+struct mah_timed_note
+mah_unpack_timed_note(mah_timed_note32 const packed, struct mah_tuplet_table const* table, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_UNPACK_TIMED_NOTE);
+
+    int index = packed >> TUPLET_SHIFT;
+    if (index > 0 && (table == NULL || index > table->size))
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_timed_note, MAH_ERROR_INVALID_TUPLET);
+    }
+
+    return (struct mah_timed_note) {
+        .tone_timed   = UNPACK_TONE(packed),
+        .acci_timed   = UNPACK_ACCI(packed),
+        .octave_timed = UNPACK_OCTAVE(packed),
+        .duration     = (packed >> DUR_SHIFT) & DUR_MASK,
+        .tuplet       = index > 0 ? table->tuplets + index - 1 : NULL,
+    };
+}
+
+void
+mah_pack_timed_notes(
+    struct mah_timed_note const notes[], mah_timed_note32 out[], int const size, struct mah_tuplet_table* table,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_PACK_TIMED_NOTES);
+
+    for (int i = 0; i < size; i++)
+    {
+        enum mah_error note_err = MAH_ERROR_NONE;
+        out[i]                  = mah_pack_timed_note(notes + i, table, &note_err);
+        if (note_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(note_err);
+            return;
+        }
+    }
+}
+
+void
+mah_unpack_timed_notes(
+    mah_timed_note32 const packed[], struct mah_timed_note out[], int const size, struct mah_tuplet_table const* table,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_UNPACK_TIMED_NOTES);
+
+    for (int i = 0; i < size; i++)
+    {
+        enum mah_error note_err = MAH_ERROR_NONE;
+        out[i]                  = mah_unpack_timed_note(packed[i], table, &note_err);
+        if (note_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(note_err);
+            return;
+        }
+    }
+}
+
+int
+mah_encode_notes(
+    struct mah_note_stream* stream, struct mah_timed_note const notes[], int const num, unsigned char out[],
+    size_t const size, size_t* written, struct mah_tuplet_table* table, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_ENCODE_NOTES);
+
+    size_t pos = 0;
+    int i      = 0;
+    for (; i < num; i++)
+    {
+        unsigned char last[MAH_NOTE_STREAM_MAX]; // near the end of out, notes are written here first
+        bool room                   = size - pos >= MAH_NOTE_STREAM_MAX;
+        struct mah_note_stream next = *stream;
+        size_t len                  = encode_note(&next, &notes[i], room ? out + pos : last, table, err);
+        if (len == 0)
+        {
+            break;
+        }
+        if (!room)
+        {
+            if (len > size - pos)
+            {
+                SET_ERR(MAH_ERROR_OVERFLOW_NOTE_STREAM);
+                break;
+            }
+            memcpy(out + pos, last, len);
+        }
+        *stream = next;
+        pos += len;
+    }
+
+    if (written != NULL)
+    {
+        *written = pos;
+    }
+    return i;
+}
+
+int
+mah_decode_notes(
+    struct mah_note_stream* stream, unsigned char const in[], size_t const size, size_t* read,
+    struct mah_timed_note out[], int const max, struct mah_tuplet_table const* table, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_DECODE_NOTES);
+
+    unsigned char const* p   = in;
+    unsigned char const* end = in + size;
+    int num                  = 0;
+    while (num < max && p < end)
+    {
+        int len = decode_note(stream, p, end, &out[num], table);
+        if (len < 0)
+        {
+            SET_ERR(MAH_ERROR_INVALID_NOTE_STREAM);
+            break;
+        }
+        if (len == 0)
+        { // note continues past in, left for the next call
+            break;
+        }
+        p += len;
+        num++;
+    }
+
+    if (read != NULL)
+    {
+        *read = (size_t) (p - in);
+    }
+    return num;
+}
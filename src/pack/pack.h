@@ -0,0 +1,70 @@
+#ifndef __MAH_PACK_H__
+#define __MAH_PACK_H__
+
+#include "err/err.h"
+#include "note/note.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Types //
+
+typedef uint16_t mah_note16;       // packed mah_note
+typedef uint32_t mah_timed_note32; // packed mah_timed_note, tuplet as index into mah_tuplet_table
+
+// Macros //
+
+#define MAH_PACK_ACCI_MIN -4       // lowest accidental of mah_note16
+#define MAH_PACK_ACCI_MAX 4        // highest accidental of mah_note16
+#define MAH_TUPLET_TABLE_MAX 4095  // most tuplets a mah_timed_note32 can reference
+#define MAH_NOTE_STREAM_MAX 14     // most bytes of one note in a note stream
+
+// Structures //
+
+typedef struct mah_tuplet_table
+{
+    int max;
+    int size;
+    struct mah_tuplet* tuplets;
+} mah_tuplet_table;
+
+typedef struct mah_note_stream
+{ // state carried between calls, starts zeroed for both encoder and decoder
+    int key;               // semitones above C-1 of the last note (kept over rests)
+    enum mah_dur duration; // duration of the last note
+    int tuplet;            // tuplet index of the last note (0 for no tuplet)
+} mah_note_stream;
+
+// Functions //
+
+mah_note16 mah_pack_note(struct mah_note note, enum mah_error* err);
+struct mah_note mah_unpack_note(mah_note16 packed);
+void mah_pack_notes(struct mah_note const notes[], mah_note16 out[], int size, enum mah_error* err);
+void mah_unpack_notes(mah_note16 const packed[], struct mah_note out[], int size);
+void mah_pack_note_batch(struct mah_note_batch const* notes, mah_note16 out[], enum mah_error* err);
+void mah_unpack_note_batch(mah_note16 const packed[], int size, struct mah_note_batch* out);
+
+mah_timed_note32 mah_pack_timed_note(
+    struct mah_timed_note const* note, struct mah_tuplet_table* table, enum mah_error* err
+);
+struct mah_timed_note mah_unpack_timed_note(
+    mah_timed_note32 packed, struct mah_tuplet_table const* table, enum mah_error* err
+);
+void mah_pack_timed_notes(
+    struct mah_timed_note const notes[], mah_timed_note32 out[], int size, struct mah_tuplet_table* table,
+    enum mah_error* err
+);
+void mah_unpack_timed_notes(
+    mah_timed_note32 const packed[], struct mah_timed_note out[], int size, struct mah_tuplet_table const* table,
+    enum mah_error* err
+);
+
+int mah_encode_notes(
+    struct mah_note_stream* stream, struct mah_timed_note const notes[], int num, unsigned char out[], size_t size,
+    size_t* written, struct mah_tuplet_table* table, enum mah_error* err
+);
+int mah_decode_notes(
+    struct mah_note_stream* stream, unsigned char const in[], size_t size, size_t* read, struct mah_timed_note out[],
+    int max, struct mah_tuplet_table const* table, enum mah_error* err
+);
+
+#endif
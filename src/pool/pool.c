@@ -0,0 +1,270 @@
+/*
+
+| pool.c |
+Defines the work stealing thread pool behind the batch functions
+Each worker owns a range of tasks, takes chunks from its front and steals half of another range when empty
+
+*/
+
+#include "pool/pool.h"
+#include "shared/shared.h"
+#include <limits.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// Macros //
+
+#define POOL_GRAIN 16     // Tasks a worker takes from its own range at once
+#define POOL_CACHE_LINE 64 // Ranges are padded to this to avoid false sharing
+
+#define RANGE(begin, end) (((uint64_t) (uint32_t) (end) << 32) | (uint32_t) (begin))
+#define RANGE_BEGIN(range) ((int) (uint32_t) (range))
+#define RANGE_END(range) ((int) ((range) >> 32))
+
+#if defined(_MSC_VER)
+#define RANGE_LOAD(p) ((uint64_t) InterlockedCompareExchange64((LONG64 volatile*) (p), 0, 0))
+#define RANGE_STORE(p, v) InterlockedExchange64((LONG64 volatile*) (p), (LONG64) (v))
+#define RANGE_CAS(p, old, new)                                                                                         \
+    ((uint64_t) InterlockedCompareExchange64((LONG64 volatile*) (p), (LONG64) (new), (LONG64) (old)) == (old))
+#else
+#define RANGE_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RANGE_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define RANGE_CAS(p, old, new)                                                                                         \
+    __atomic_compare_exchange_n((p), &(uint64_t) { old }, (new), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#endif
+
+// Structures //
+
+struct pool_slot
+{
+    uint64_t volatile range; // tasks left to this worker, packed by RANGE
+    unsigned char pad[POOL_CACHE_LINE - sizeof(uint64_t)];
+};
+
+struct pool
+{
+    pool_task task;
+    void* ctx;
+    int workers;
+    struct pool_slot slots[MAH_THREADS_MAX];
+};
+
+struct pool_worker
+{
+    struct pool* pool;
+    int id;
+};
+
+// Internal Functions //
+
+static bool
+take_range(struct pool_slot* slot, int* begin, int* end)
+{ // takes up to POOL_GRAIN tasks from the front of the worker's own range
+    for (;;)
+    {
+        uint64_t old = RANGE_LOAD(&slot->range);
+        int lo       = RANGE_BEGIN(old);
+        int hi       = RANGE_END(old);
+        if (lo >= hi)
+        {
+            return false;
+        }
+
+        int next = hi - lo > POOL_GRAIN ? lo + POOL_GRAIN : hi;
+        if (RANGE_CAS(&slot->range, old, RANGE(next, hi)))
+        {
+            *begin = lo;
+            *end   = next;
+            return true;
+        }
+    }
+}
+
+static bool
+steal_range(struct pool_slot* victim, struct pool_slot* thief)
+{ // moves the back half of the victim's range to the thief
+    for (;;)
+    {
+        uint64_t old = RANGE_LOAD(&victim->range);
+        int lo       = RANGE_BEGIN(old);
+        int hi       = RANGE_END(old);
+        if (lo >= hi)
+        {
+            return false;
+        }
+
+        int mid = lo + (hi - lo) / 2;
+        if (RANGE_CAS(&victim->range, old, RANGE(lo, mid)))
+        {
+            RANGE_STORE(&thief->range, RANGE(mid, hi));
+            return true;
+        }
+    }
+}
+
+static void
+work(struct pool* pool, int const id)
+{
+    struct pool_slot* own = &pool->slots[id];
+    for (;;)
+    {
+        int begin, end;
+        while (take_range(own, &begin, &end))
+        {
+            pool->task(pool->ctx, begin, end, id);
+        }
+
+        bool stole = false;
+        for (int i = 1; i < pool->workers && !stole; i++)
+        { // every range is empty once nothing can be stolen, in flight tasks are never split
+            stole = steal_range(&pool->slots[(id + i) % pool->workers], own);
+        }
+        if (!stole)
+        {
+            return;
+        }
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI
+work_thread(LPVOID arg)
+{
+    struct pool_worker* worker = arg;
+    work(worker->pool, worker->id);
+    return 0;
+}
+#else
+static void*
+work_thread(void* arg)
+{
+    struct pool_worker* worker = arg;
+    work(worker->pool, worker->id);
+    return NULL;
+}
+#endif
+
+static int
+count_cores(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int) info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int) cores : 1;
+#endif
+}
+
+// Functions //
+
+int
+pool_workers(int const threads, int const size, int const min_size)
+{ // threads to use for size tasks, 0 threads is one per core
+    int workers = threads > 0 ? threads : count_cores();
+    int chunks  = (size + POOL_GRAIN - 1) / POOL_GRAIN;
+    if (workers > MAH_THREADS_MAX)
+    {
+        workers = MAH_THREADS_MAX;
+    }
+    if (workers > chunks)
+    {
+        workers = chunks;
+    }
+    if (min_size > 1 && workers > size / min_size)
+    { // threads are started on every call, so each must get enough tasks to pay for its start
+        workers = size / min_size;
+    }
+    return workers > 1 ? workers : 1;
+}
+
+void
+pool_run(int const workers, int const size, pool_task task, void* ctx)
+{ // runs task over size tasks on workers threads (including the calling thread)
+    if (workers <= 1)
+    {
+        if (size > 0)
+        {
+            task(ctx, 0, size, 0);
+        }
+        return;
+    }
+
+    struct pool pool = { .task = task, .ctx = ctx, .workers = workers };
+    for (int i = 0; i < workers; i++)
+    { // split tasks evenly, stealing evens out the rest
+        pool.slots[i].range = RANGE((long long) size * i / workers, (long long) size * (i + 1) / workers);
+    }
+
+    struct pool_worker args[MAH_THREADS_MAX];
+#if defined(_WIN32)
+    HANDLE threads[MAH_THREADS_MAX];
+#else
+    pthread_t threads[MAH_THREADS_MAX];
+#endif
+    bool started[MAH_THREADS_MAX] = { false };
+    for (int i = 1; i < workers; i++)
+    { // a worker that fails to start leaves its range to be stolen
+        args[i] = (struct pool_worker) { &pool, i };
+#if defined(_WIN32)
+        threads[i] = CreateThread(NULL, 0, work_thread, &args[i], 0, NULL);
+        started[i] = threads[i] != NULL;
+#else
+        started[i] = pthread_create(&threads[i], NULL, work_thread, &args[i]) == 0;
+#endif
+    }
+
+    work(&pool, 0);
+    for (int i = 1; i < workers; i++)
+    {
+        if (!started[i])
+        {
+            continue;
+        }
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+}
+
+void
+pool_start_fails(struct pool_fail fails[], int const workers)
+{
+    for (int i = 0; i < workers; i++)
+    {
+        fails[i] = (struct pool_fail) { INT_MAX, MAH_ERROR_NONE };
+    }
+}
+
+void
+pool_set_fail(struct pool_fail* fail, int const task, enum mah_error const err)
+{ // keeps the lowest failing task of a worker
+    if (err != MAH_ERROR_NONE && task < fail->task)
+    {
+        *fail = (struct pool_fail) { task, err };
+    }
+}
+
+enum mah_error
+pool_first_fail(struct pool_fail const fails[], int const workers)
+{ // error of the lowest failing task, the same for any schedule
+    struct pool_fail first = { INT_MAX, MAH_ERROR_NONE };
+    for (int i = 0; i < workers; i++)
+    {
+        if (fails[i].task < first.task)
+        {
+            first = fails[i];
+        }
+    }
+    return first.err;
+}
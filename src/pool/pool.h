@@ -0,0 +1,27 @@
+#ifndef __MAH_POOL_H__
+#define __MAH_POOL_H__
+
+#include "err/err.h"
+#include "shared/shared.h"
+
+// Types //
+
+typedef void (*pool_task)(void* ctx, int begin, int end, int worker); // runs tasks begin to end - 1
+
+// Structures //
+
+struct pool_fail
+{ // first task of a worker that failed
+    int task;
+    enum mah_error err;
+};
+
+// Functions //
+
+int pool_workers(int threads, int size, int min_size);
+void pool_run(int workers, int size, pool_task task, void* ctx);
+void pool_start_fails(struct pool_fail fails[], int workers);
+void pool_set_fail(struct pool_fail* fail, int task, enum mah_error err);
+enum mah_error pool_first_fail(struct pool_fail const fails[], int workers);
+
+#endif
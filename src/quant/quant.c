@@ -0,0 +1,336 @@
+/*
+
+| quant.c |
+Defines the onset quantizer, which writes performed notes as durations, dots and tuplets
+A dynamic program picks a grid point near each onset so that the notes and rests between them cost the least
+
+*/
+
+#include "quant/quant.h"
+#include "shared/shared.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// Macros //
+
+#define QUANT_WIDTH (2 * MAH_QUANT_WINDOW + 1) // most grid points tried per note
+#define QUANT_LAST -1                          // span of the last note, which is not followed by rests
+
+// Structures //
+
+struct quant_step
+{ // grid points tried for one note
+    int64_t first;                   // grid point of position 0
+    unsigned char back[QUANT_WIDTH]; // position of previous note on the cheapest path to each position
+    unsigned char pick;              // position on the cheapest path of the whole performance
+};
+
+// Internal Functions //
+
+static bool
+add_candidate(struct mah_quant_table* table, struct mah_timed_note note, int const tuplet, double const cost)
+{ // adds duration of note to candidates, false if it is not a whole number of grid points
+    int num                = 0;
+    int den                = 1;
+    enum mah_error dur_err = MAH_ERROR_NONE;
+    mah_get_duration_fraction(&note, &num, &den, &dur_err);
+    int64_t ticks = (int64_t) 4 * table->config.divisions * num;
+    if (dur_err != MAH_ERROR_NONE || ticks % den != 0)
+    {
+        return false;
+    }
+
+    int c              = table->num++;
+    table->ticks[c]    = (int) (ticks / den);
+    table->cost[c]     = cost;
+    table->duration[c] = note.duration;
+    table->tuplet[c]   = tuplet;
+    if (table->ticks[c] > table->ticks[table->longest])
+    {
+        table->longest = c;
+    }
+    return true;
+}
+
+static double
+rest_cost(struct mah_quant_table const* table, int64_t span)
+{ // penalty of the cheapest rests filling span grid points, HUGE_VAL if none do
+    double cost = 0;
+    if (span >= table->span)
+    { // long rests take pieces of the longest candidate until the rest is in the table
+        int64_t pieces = (span - table->span) / table->ticks[table->longest] + 1;
+        cost           = (double) pieces * (table->config.rest_penalty + table->cost[table->longest]);
+        span -= pieces * table->ticks[table->longest];
+    }
+    return cost + table->rest_cost[span];
+}
+
+static int
+note_candidate(struct mah_quant_table const* table, int64_t const span, double const length, double* cost)
+{ // cheapest candidate for a note played for length grid points and followed by rests up to span, -1 if none fit
+    int best = -1;
+    *cost    = HUGE_VAL;
+    for (int c = 0; c < table->num; c++)
+    {
+        int64_t rest = span - table->ticks[c];
+        if (span != QUANT_LAST && rest < 0)
+        {
+            continue;
+        }
+
+        double note_cost = table->cost[c] + table->config.length_weight * fabs(table->ticks[c] - length);
+        if (span != QUANT_LAST)
+        {
+            note_cost += rest_cost(table, rest);
+        }
+        if (note_cost < *cost)
+        {
+            *cost = note_cost;
+            best  = c;
+        }
+    }
+    return best;
+}
+
+static void
+add_note(
+    struct mah_quant_table const* table, struct mah_note const* note, int const c, struct mah_timed_note out[],
+    int const max, int* size
+)
+{ // writes candidate c as note (or as a rest if note is NULL), only counting it past max
+    if (*size < max)
+    {
+        int tuplet = table->tuplet[c];
+        out[*size] = (struct mah_timed_note) {
+            .tone_timed   = note ? note->tone : MAH_REST,
+            .acci_timed   = note ? note->acci : 0,
+            .octave_timed = note ? note->octave : MAH_OCTAVE_0,
+            .duration     = table->duration[c],
+            .tuplet       = tuplet ? table->config.tuplets + tuplet - 1 : NULL,
+        };
+    }
+    (*size)++;
+}
+
+static void
+add_rests(
+    struct mah_quant_table const* table, int64_t span, struct mah_timed_note out[], int const max, int* size
+)
+{ // writes the rests priced by rest_cost
+    for (; span >= table->span; span -= table->ticks[table->longest])
+    {
+        add_note(table, NULL, table->longest, out, max, size);
+    }
+    for (; span > 0; span -= table->ticks[table->rest_first[span]])
+    {
+        add_note(table, NULL, table->rest_first[span], out, max, size);
+    }
+}
+
+// Functions //
+
+void
+mah_get_quant_table(struct mah_quant_table* table, struct mah_quant_config const* config, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_QUANT_TABLE);
+
+    // negated so NaN weights fail too
+    if (config->divisions <= 0 || config->window < 0 || config->window > MAH_QUANT_WINDOW ||
+        config->num_tuplets < 0 || config->num_tuplets > MAH_QUANT_MAX - MAH_TUPLET || !(config->onset_weight >= 0) ||
+        !(config->length_weight >= 0) || !(config->dot_penalty >= 0) || !(config->tuplet_penalty >= 0) ||
+        !(config->rest_penalty >= 0) || config->divisions > MAH_QUANT_SPAN)
+    {
+        SET_ERR(MAH_ERROR_INVALID_QUANTIZE);
+        return;
+    }
+
+    table->config  = *config;
+    table->num     = 0;
+    table->longest = 0;
+    for (int d = MAH_DOTTED_WHOLE; d < MAH_TUPLET; d++)
+    { // plain durations shorter than the grid are left out
+        bool dotted = d < MAH_SIXTYFOURTH && d % 2 == 0;
+        add_candidate(
+            table, (struct mah_timed_note) { .duration = (enum mah_dur) d }, 0, dotted ? config->dot_penalty : 0
+        );
+    }
+    for (int t = 0; t < config->num_tuplets; t++)
+    {
+        enum mah_error tuplet_err = MAH_ERROR_NONE;
+        struct mah_tuplet* tuplet = config->tuplets + t;
+        mah_create_tuplet(tuplet->n, tuplet->m, tuplet->base, &tuplet_err);
+        if (tuplet_err != MAH_ERROR_NONE ||
+            !add_candidate(
+                table, (struct mah_timed_note) { .duration = MAH_TUPLET, .tuplet = tuplet }, t + 1,
+                config->tuplet_penalty
+            ))
+        { // tuplets were asked for, so one off the grid is an error
+            SET_ERR(MAH_ERROR_INVALID_TUPLET);
+            return;
+        }
+    }
+
+    table->span = 2 * table->ticks[table->longest];
+    if (table->num == 0 || table->span > MAH_QUANT_SPAN)
+    {
+        SET_ERR(MAH_ERROR_INVALID_QUANTIZE);
+        return;
+    }
+
+    table->rest_cost[0]  = 0;
+    table->rest_first[0] = -1;
+    for (int s = 1; s < table->span; s++)
+    { // cheapest rests by the number of grid points they fill, built on shorter ones
+        table->rest_cost[s]  = HUGE_VAL;
+        table->rest_first[s] = -1;
+        for (int c = 0; c < table->num; c++)
+        {
+            if (table->ticks[c] > s)
+            {
+                continue;
+            }
+            double cost = table->rest_cost[s - table->ticks[c]] + config->rest_penalty + table->cost[c];
+            if (cost < table->rest_cost[s])
+            {
+                table->rest_cost[s]  = cost;
+                table->rest_first[s] = (signed char) c;
+            }
+        }
+    }
+}
+
+int
+mah_quantize_notes(
+    struct mah_played_note const notes[], int const num, double const tempo, struct mah_quant_table const* table,
+    struct mah_arena* arena, struct mah_timed_note out[], int const max, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_QUANTIZE_NOTES);
+
+    if (num < 0 || arena == NULL)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return 0;
+    }
+    if (!(tempo > 0) || !isfinite(tempo))
+    {
+        SET_ERR(MAH_ERROR_INVALID_QUANTIZE);
+        return 0;
+    }
+    if (num == 0)
+    {
+        return 0;
+    }
+
+    // steps only live during the call, so the arena is given back before returning
+    size_t used              = arena->used;
+    struct quant_step* steps = mah_arena_alloc(arena, sizeof(*steps) * (size_t) num, sizeof(int64_t), err);
+    if (steps == NULL)
+    {
+        return 0;
+    }
+
+    double grid = tempo * table->config.divisions / 60; // grid points per second
+    int width   = 2 * table->config.window + 1;
+    double cost[QUANT_WIDTH];
+    double next[QUANT_WIDTH];
+    double spans[2 * QUANT_WIDTH - 1];
+    for (int i = 0; i < num; i++)
+    {
+        double onset = notes[i].onset * grid;
+        if (!(onset >= 0) || !isfinite(onset) || !isfinite(notes[i].offset) ||
+            (i > 0 && notes[i].onset < notes[i - 1].onset))
+        {
+            arena->used = used;
+            SET_ERR(MAH_ERROR_INVALID_QUANTIZE);
+            return 0;
+        }
+
+        // positions are kept after those of the previous note, so notes played together still get a place
+        int64_t first  = llround(onset) - table->config.window;
+        first          = first < 0 ? 0 : first;
+        first          = i > 0 && first <= steps[i - 1].first ? steps[i - 1].first + 1 : first;
+        steps[i].first = first;
+        if (i == 0)
+        { // the performance starts at grid point 0, so the first note may follow rests
+            for (int k = 0; k < width; k++)
+            {
+                next[k] = rest_cost(table, first + k) + table->config.onset_weight * fabs((double) (first + k) - onset);
+            }
+        }
+        else
+        { // span from position j of the previous note to position k is delta + k - j, priced once per difference
+            double length = (notes[i - 1].offset - notes[i - 1].onset) * grid;
+            int64_t delta = first - steps[i - 1].first;
+            for (int s = 0; s < 2 * width - 1; s++)
+            {
+                int64_t span = delta + s - (width - 1);
+                spans[s]     = HUGE_VAL;
+                if (span > 0)
+                {
+                    note_candidate(table, span, length, &spans[s]);
+                }
+            }
+            for (int k = 0; k < width; k++)
+            {
+                double best = HUGE_VAL;
+                int back    = 0;
+                for (int j = 0; j < width; j++)
+                {
+                    double path = cost[j] + spans[k - j + width - 1];
+                    if (path < best)
+                    {
+                        best = path;
+                        back = j;
+                    }
+                }
+                next[k]          = best + table->config.onset_weight * fabs((double) (first + k) - onset);
+                steps[i].back[k] = (unsigned char) back;
+            }
+        }
+        memcpy(cost, next, sizeof(double) * (size_t) width);
+    }
+
+    // the last note costs the same at every position, so it does not change the pick
+    int pick = 0;
+    for (int k = 1; k < width; k++)
+    {
+        pick = cost[k] < cost[pick] ? k : pick;
+    }
+    if (cost[pick] == HUGE_VAL)
+    {
+        arena->used = used;
+        SET_ERR(MAH_ERROR_INVALID_QUANTIZE);
+        return 0;
+    }
+    for (int i = num - 1; i > 0; i--)
+    {
+        steps[i].pick = (unsigned char) pick;
+        pick          = steps[i].back[pick];
+    }
+    steps[0].pick = (unsigned char) pick;
+
+    int size = 0;
+    add_rests(table, steps[0].first + steps[0].pick, out, max, &size);
+    for (int i = 0; i < num; i++)
+    {
+        double note_cost = 0;
+        double length    = (notes[i].offset - notes[i].onset) * grid;
+        int64_t start    = steps[i].first + steps[i].pick;
+        int64_t span     = i + 1 < num ? steps[i + 1].first + steps[i + 1].pick - start : QUANT_LAST;
+        int c            = note_candidate(table, span, length, &note_cost);
+        add_note(table, &notes[i].note, c, out, max, &size);
+        if (span != QUANT_LAST)
+        {
+            add_rests(table, span - table->ticks[c], out, max, &size);
+        }
+    }
+
+    arena->used = used;
+    if (size > max)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_QUANTIZE);
+    }
+    return size;
+}
@@ -0,0 +1,58 @@
+#ifndef __MAH_QUANT_H__
+#define __MAH_QUANT_H__
+
+#include "arena/arena.h"
+#include "err/err.h"
+#include "note/note.h"
+
+// Macros //
+
+#define MAH_QUANT_MAX 32    // most candidate durations of a quantizer (14 plain and dotted, the rest tuplets)
+#define MAH_QUANT_WINDOW 8  // most grid points tried on each side of an onset
+#define MAH_QUANT_SPAN 2048 // most grid points of rests looked up in a table (longer rests take whole pieces)
+
+// Structures //
+
+typedef struct mah_quant_config
+{
+    int divisions;              // grid points per quarter note
+    int window;                 // grid points tried on each side of an onset
+    struct mah_tuplet* tuplets; // tuplets allowed besides plain and dotted durations (made by mah_create_tuplet)
+    int num_tuplets;
+    double onset_weight;        // penalty per grid point an onset is moved
+    double length_weight;       // penalty per grid point a note is longer or shorter than played
+    double dot_penalty;         // penalty of each dotted duration
+    double tuplet_penalty;      // penalty of each tuplet
+    double rest_penalty;        // penalty of each rest
+} mah_quant_config;
+
+typedef struct mah_quant_table
+{ // candidate durations of a config, only read once built
+    struct mah_quant_config config;
+    int num;                                // candidates
+    int ticks[MAH_QUANT_MAX];               // grid points of each candidate
+    double cost[MAH_QUANT_MAX];             // penalty of each candidate
+    enum mah_dur duration[MAH_QUANT_MAX];   // duration of each candidate
+    int tuplet[MAH_QUANT_MAX];              // index + 1 into config.tuplets, 0 for no tuplet
+    int longest;                            // candidate with the most grid points
+    int span;                               // rests shorter than span grid points are in rest_cost
+    double rest_cost[MAH_QUANT_SPAN];       // penalty of the cheapest rests filling each number of grid points
+    signed char rest_first[MAH_QUANT_SPAN]; // first candidate of those rests, -1 if none fit
+} mah_quant_table;
+
+typedef struct mah_played_note
+{
+    struct mah_note note;
+    double onset;  // seconds from start of performance
+    double offset; // seconds from start of performance
+} mah_played_note;
+
+// Functions //
+
+void mah_get_quant_table(struct mah_quant_table* table, struct mah_quant_config const* config, enum mah_error* err);
+int mah_quantize_notes(
+    struct mah_played_note const notes[], int num, double tempo, struct mah_quant_table const* table,
+    struct mah_arena* arena, struct mah_timed_note out[], int max, enum mah_error* err
+);
+
+#endif
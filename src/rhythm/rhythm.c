@@ -3,17 +3,323 @@
 | rhythm.c |
 Rhythm and timing support for mahler music theory library
 Provides time signature validation and measure analysis
+Streams are cut into measures in one pass, reporting every measure that does not fill its time signature
+Notes crossing barlines (or beats) are split into tied notes that can be notated
+Tempo maps keep the seconds at each tempo change, so converting a position is a search and a multiply
 
 */
 
 #include "rhythm/rhythm.h"
+#include "pool/pool.h"
+#include "shared/shared.h"
+#include <math.h>
 #include <stddef.h>
 
+// Macros //
+
+#define MEASURE_BATCH_MIN 2048 // notes per thread of mah_validate_measure_batch, fewer cost less than starting it
+
+// Structures //
+
+struct measure_batch
+{ // shared by the workers of mah_validate_measure_batch
+    struct mah_timed_note const* notes;
+    size_t const* offsets;
+    struct mah_time_change const* changes;
+    int const* change_offsets;
+    struct mah_measure_list* lists;
+    struct pool_fail fails[MAH_THREADS_MAX];
+};
+
+// Internal Functions //
+
+static bool
+is_time_sig(struct mah_time_sig const time_sig)
+{ // denominators are powers of 2 up to a sixtyfourth, so a beat is a whole number of ticks at any scale used here
+    return time_sig.numerator > 0 && time_sig.denominator > 0 && time_sig.denominator <= 64 &&
+           (time_sig.denominator & (time_sig.denominator - 1)) == 0;
+}
+
+static enum mah_error
+time_sig_ticks(struct mah_time_sig const time_sig, int64_t* ticks)
+{ // ticks of a full measure of time_sig, at the scale of mah_get_duration_ticks
+    if (!is_time_sig(time_sig))
+    {
+        return MAH_ERROR_INVALID_TIME_SIG;
+    }
+
+    *ticks = (int64_t) time_sig.numerator * (WHOLE_TICKS / time_sig.denominator);
+    return MAH_ERROR_NONE;
+}
+
+static void
+add_measure_error(struct mah_measure_stream const* stream, struct mah_measure_list* list, enum mah_error* err)
+{ // adds open measure of stream to list, dropping it if list is full so the stream keeps going
+    ADD_RESULT(
+        MAH_ERROR_OVERFLOW_MEASURE_RETURN,
+        (struct mah_measure_error) {
+            .measure  = stream->measure,
+            .note     = stream->first,
+            .num      = stream->note - stream->first,
+            .ticks    = stream->ticks,
+            .expected = stream->expected,
+        }
+    );
+}
+
+static void
+close_measure(struct mah_measure_stream* stream, struct mah_measure_list* list, enum mah_error* err)
+{ // reports open measure if its notes do not fill it exactly, then opens the next one
+    if (stream->ticks != stream->expected)
+    {
+        add_measure_error(stream, list, err);
+    }
+
+    stream->measure++;
+    stream->first = stream->note;
+    stream->ticks = 0;
+    if (stream->change + 1 < stream->num_changes && stream->changes[stream->change + 1].measure == stream->measure)
+    { // checked by mah_start_measures
+        stream->change++;
+        time_sig_ticks(stream->changes[stream->change].time_sig, &stream->expected);
+    }
+}
+
+static void
+segment_notes(
+    struct mah_measure_stream* stream, struct mah_timed_note const notes[], size_t const num,
+    struct mah_measure_list* list, enum mah_error* err
+)
+{ // a measure closes on the note that reaches its length, so a note crossing the barline makes it too long
+    for (size_t i = 0; i < num; i++)
+    {
+        int64_t ticks = 0;
+        if (notes[i].duration >= MAH_DOTTED_WHOLE && notes[i].duration < MAH_TUPLET)
+        {
+            ticks = DUR_TICKS(notes[i].duration, WHOLE_TICKS);
+        }
+        else
+        { // only tuplets (and invalid durations) pay for the full conversion
+            struct mah_timed_note note = notes[i];
+            enum mah_error note_err    = MAH_ERROR_NONE;
+            ticks                      = mah_get_duration_ticks(&note, &note_err);
+            if (note_err != MAH_ERROR_NONE)
+            {
+                SET_ERR(note_err);
+                return;
+            }
+        }
+
+        stream->note++;
+        stream->ticks += ticks;
+        if (stream->ticks >= stream->expected)
+        {
+            close_measure(stream, list, err);
+        }
+    }
+}
+
+static void
+add_tied_note(struct mah_tied_list* list, struct mah_timed_note const* note, bool const tie, enum mah_error* err)
+{ // adds note to list, dropping it if list is full so the stream keeps going
+    ADD_RESULT(MAH_ERROR_OVERFLOW_TIE_RETURN, (struct mah_tied_note) { *note, tie && note->tone_timed != MAH_REST });
+}
+
+static enum mah_error
+written_ticks(
+    struct mah_timeline const* timeline, struct mah_timed_note const* note, uint64_t const ticks, uint64_t* written
+)
+{ // ticks of the plain durations that write a piece of note, scaled back by the ratio of its tuplet
+    *written = ticks;
+    if (note->duration == MAH_TUPLET)
+    { // tuplet is in timeline, so n and m are positive
+        uint64_t n = (uint64_t) note->tuplet->n;
+        uint64_t m = (uint64_t) note->tuplet->m;
+        if (ticks > UINT64_MAX / n || ticks * n % m != 0)
+        {
+            return MAH_ERROR_INVALID_SPLIT;
+        }
+        *written = ticks * n / m;
+    }
+    return *written % timeline->ticks[MAH_ONETWENTYEIGHTH] == 0 ? MAH_ERROR_NONE : MAH_ERROR_INVALID_SPLIT;
+}
+
+static enum mah_error
+split_note(
+    struct mah_tie_stream* stream, struct mah_timed_note const* note, uint64_t written, bool const last,
+    struct mah_tied_list* list, enum mah_error* err
+)
+{ // adds written ticks of note as the fewest durations (longest first) tied together, keeping its tuplet ratio
+    uint64_t const* ticks = stream->timeline->ticks;
+    for (int d = MAH_DOTTED_WHOLE; written > 0;)
+    { // ends on a onetwentyeighth at most, checked by written_ticks
+        if (ticks[d] > written)
+        {
+            d++;
+            continue;
+        }
+
+        struct mah_timed_note piece = *note;
+        piece.duration              = (enum mah_dur) d;
+        piece.tuplet                = NULL;
+        if (note->duration == MAH_TUPLET)
+        {
+            enum mah_error tuplet_err = MAH_ERROR_NONE;
+            struct mah_tuplet tuplet  = { note->tuplet->n, note->tuplet->m, (enum mah_dur) d };
+            int index                 = find_tuplet(stream->tuplets, &tuplet, &tuplet_err);
+            if (index == 0)
+            {
+                return tuplet_err;
+            }
+            piece.duration = MAH_TUPLET;
+            piece.tuplet   = stream->tuplets->tuplets + index - 1;
+        }
+        written -= ticks[d];
+        add_tied_note(list, &piece, written > 0 || !last, err);
+    }
+    return MAH_ERROR_NONE;
+}
+
+static enum mah_error
+split_across(
+    struct mah_tie_stream* stream, struct mah_timed_note const* note, uint64_t const ticks,
+    struct mah_tied_list* list, enum mah_error* err
+)
+{ // splits note at every split point it crosses, removing the pieces it added if one fails
+    int size                 = list->size;
+    int tuplets              = stream->tuplets != NULL ? stream->tuplets->size : 0;
+    uint64_t room            = stream->split - stream->tick;
+    uint64_t after           = ticks - room;
+    uint64_t first           = 0;
+    uint64_t whole           = 0;
+    uint64_t rest            = 0;
+    enum mah_error split_err = written_ticks(stream->timeline, note, room, &first);
+    if (split_err == MAH_ERROR_NONE && after >= stream->split)
+    {
+        split_err = written_ticks(stream->timeline, note, stream->split, &whole);
+    }
+    if (split_err == MAH_ERROR_NONE && after % stream->split != 0)
+    {
+        split_err = written_ticks(stream->timeline, note, after % stream->split, &rest);
+    }
+
+    split_err = split_err != MAH_ERROR_NONE ? split_err : split_note(stream, note, first, false, list, err);
+    for (uint64_t s = after / stream->split; split_err == MAH_ERROR_NONE && s > 0; s--)
+    {
+        split_err = split_note(stream, note, whole, s == 1 && rest == 0, list, err);
+    }
+    split_err = split_err != MAH_ERROR_NONE ? split_err : split_note(stream, note, rest, true, list, err);
+    if (split_err != MAH_ERROR_NONE)
+    { // pieces resolve their tuplets one at a time, so a later piece can fail after earlier ones were added
+        list->size = size;
+        if (stream->tuplets != NULL)
+        {
+            stream->tuplets->size = tuplets;
+        }
+        return split_err;
+    }
+    stream->tick = after % stream->split;
+    return MAH_ERROR_NONE;
+}
+
+static void
+validate_measure_task(void* ctx, int const begin, int const end, int const worker)
+{ // each score only writes its own list, so results do not depend on the schedule
+    struct measure_batch* batch = ctx;
+    for (int s = begin; s < end; s++)
+    {
+        enum mah_error score_err         = MAH_ERROR_NONE;
+        int first                        = batch->change_offsets[s];
+        struct mah_measure_stream stream = mah_start_measures(
+            batch->changes + first, batch->change_offsets[s + 1] - first, &score_err
+        );
+        if (score_err == MAH_ERROR_NONE)
+        {
+            segment_notes(
+                &stream, batch->notes + batch->offsets[s], batch->offsets[s + 1] - batch->offsets[s],
+                &batch->lists[s], &score_err
+            );
+        }
+        if (score_err == MAH_ERROR_NONE || score_err == MAH_ERROR_OVERFLOW_MEASURE_RETURN)
+        { // a full list still counts the last measure
+            mah_end_measures(&stream, &batch->lists[s], &score_err);
+        }
+        pool_set_fail(&batch->fails[worker], s, score_err);
+    }
+}
+
+static int
+tick_point(struct mah_tempo_map const* map, uint64_t const tick)
+{ // index of the last point at or before tick, the first point is at tick 0
+    int first = 0;
+    for (int len = map->num; len > 1; len -= len / 2)
+    { // halves without a branch, since the side taken is as random as the positions asked for
+        first = map->points[first + len / 2].tick <= tick ? first + len / 2 : first;
+    }
+    return first;
+}
+
+static int
+seconds_point(struct mah_tempo_map const* map, double const seconds)
+{ // index of the last point at or before seconds, the first point is at 0 seconds
+    int first = 0;
+    for (int len = map->num; len > 1; len -= len / 2)
+    { // halves without a branch, since the side taken is as random as the positions asked for
+        first = map->points[first + len / 2].seconds <= seconds ? first + len / 2 : first;
+    }
+    return first;
+}
+
+static double
+point_seconds(struct mah_tempo_point const* point, uint64_t const tick)
+{
+    return point->seconds + (double) (tick - point->tick) * point->per_tick;
+}
+
+static enum mah_error
+point_tick(struct mah_tempo_point const* point, double const seconds, uint64_t* tick)
+{ // nearest tick to seconds (at or after point) in the tempo of point
+    if (!(seconds >= 0) || !isfinite(seconds))
+    {
+        return MAH_ERROR_INVALID_RANGE;
+    }
+
+    double offset = floor((seconds - point->seconds) * point->per_second + 0.5);
+    if (offset >= 0x1p64 || (uint64_t) offset > UINT64_MAX - point->tick)
+    {
+        return MAH_ERROR_INVALID_RANGE;
+    }
+    *tick = point->tick + (uint64_t) offset;
+    return MAH_ERROR_NONE;
+}
+
+static enum mah_error
+tempo_point(struct mah_tempo_point const* prev, struct mah_tempo_change const* change, struct mah_tempo_point* point)
+{ // point of change, after the point prev (NULL for the first change)
+    double per_tick   = 60 / (change->bpm * (double) DUR_TICKS(MAH_QUARTER, WHOLE_TICKS));
+    double per_second = change->bpm * (double) DUR_TICKS(MAH_QUARTER, WHOLE_TICKS) / 60;
+    double seconds    = prev != NULL ? point_seconds(prev, change->tick) : 0;
+    if ((prev != NULL ? change->tick <= prev->tick : change->tick != 0) || !(per_tick > 0) || !(per_second > 0) ||
+        !isfinite(per_tick) || !isfinite(per_second) || !isfinite(seconds))
+    {
+        return MAH_ERROR_INVALID_TEMPO;
+    }
+    *point = (struct mah_tempo_point) {
+        .tick       = change->tick,
+        .seconds    = seconds,
+        .per_tick   = per_tick,
+        .per_second = per_second,
+    };
+    return MAH_ERROR_NONE;
+}
+
 // Time signature and measure validation //
 
 void
 mah_validate_measure(struct mah_timed_note* notes, int count, struct mah_time_sig time_sig, enum mah_error* err)
 {
+    PROFILE(MAH_STATS_VALIDATE_MEASURE);
+
     if (!err) return;
     
     if (!notes || count <= 0) {
@@ -32,22 +338,12 @@ mah_validate_measure(struct mah_timed_note* notes, int count, struct mah_time_si
     // For 3/4: 3 quarter notes = 3 * 480 = 1440 ticks
     // For 6/8: 6 eighth notes = 6 * 240 = 1440 ticks
     
-    int beat_ticks;
-    switch (time_sig.denominator) {
-        case 1:  beat_ticks = 1920; break;  // Whole note
-        case 2:  beat_ticks = 960;  break;  // Half note
-        case 4:  beat_ticks = 480;  break;  // Quarter note  
-        case 8:  beat_ticks = 240;  break;  // Eighth note
-        case 16: beat_ticks = 120;  break;  // Sixteenth note
-        case 32: beat_ticks = 60;   break;  // Thirty-second note
-        case 64: beat_ticks = 30;   break;  // Sixty-fourth note
-        default:
-            *err = MAH_ERROR_INVALID_TIME_SIG;
-            return;
+    int64_t expected_ticks;
+    if (time_sig_ticks(time_sig, &expected_ticks) != MAH_ERROR_NONE) {
+        *err = MAH_ERROR_INVALID_TIME_SIG;
+        return;
     }
     
-    int expected_ticks = time_sig.numerator * beat_ticks;
-    
     // Sum up all note durations in the measure
     int total_ticks = 0;
     enum mah_error note_err = MAH_ERROR_NONE;
@@ -67,4 +363,305 @@ mah_validate_measure(struct mah_timed_note* notes, int count, struct mah_time_si
     }
     
     *err = MAH_ERROR_NONE;
+}
+
+// Streaming measure segmentation //
+
+struct mah_measure_stream
+mah_start_measures(struct mah_time_change const changes[], int const num, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_START_MEASURES);
+
+    int64_t expected = 0;
+    if (num <= 0 || changes[0].measure != 0)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_measure_stream, MAH_ERROR_INVALID_TIME_SIG);
+    }
+    for (int c = num - 1; c >= 0; c--)
+    { // ends on the first change, whose ticks open the stream
+        if (time_sig_ticks(changes[c].time_sig, &expected) != MAH_ERROR_NONE ||
+            (c > 0 && changes[c].measure <= changes[c - 1].measure))
+        {
+            RETURN_EMPTY_STRUCT_ERR(mah_measure_stream, MAH_ERROR_INVALID_TIME_SIG);
+        }
+    }
+
+    return (struct mah_measure_stream) {
+        .changes     = changes,
+        .num_changes = num,
+        .expected    = expected,
+    };
+}
+
+void
+mah_segment_measures(
+    struct mah_measure_stream* stream, struct mah_timed_note const notes[], int const num,
+    struct mah_measure_list* list, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_SEGMENT_MEASURES);
+
+    if (num < 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return;
+    }
+    segment_notes(stream, notes, (size_t) num, list, err);
+}
+
+void
+mah_end_measures(struct mah_measure_stream* stream, struct mah_measure_list* list, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_END_MEASURES);
+
+    if (stream->note > stream->first)
+    { // open measure is short, or it would have closed on its last note
+        close_measure(stream, list, err);
+    }
+}
+
+void
+mah_validate_measure_batch(
+    struct mah_timed_note const notes[], size_t const offsets[], int const num, struct mah_time_change const changes[],
+    int const change_offsets[], struct mah_measure_list lists[], int const threads, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_VALIDATE_MEASURE_BATCH);
+
+    struct measure_batch batch = {
+        .notes          = notes,
+        .offsets        = offsets,
+        .changes        = changes,
+        .change_offsets = change_offsets,
+        .lists          = lists,
+    };
+    // scores differ in length, so each thread gets enough scores for MEASURE_BATCH_MIN notes on average
+    size_t each = num > 0 ? (offsets[num] - offsets[0]) / (size_t) num + 1 : 1;
+    int workers = pool_workers(threads, num, (int) (MEASURE_BATCH_MIN / each));
+    pool_start_fails(batch.fails, workers);
+    pool_run(workers, num, validate_measure_task, &batch);
+
+    enum mah_error batch_err = pool_first_fail(batch.fails, workers);
+    if (batch_err != MAH_ERROR_NONE)
+    {
+        SET_ERR(batch_err);
+    }
+}
+
+// Barline splitting and ties //
+
+struct mah_tie_stream
+mah_start_ties(
+    struct mah_timeline const* timeline, struct mah_time_sig const time_sig, bool const beats,
+    struct mah_tuplet_table* tuplets, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_START_TIES);
+
+    if (!is_time_sig(time_sig) || timeline->resolution == 0)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_tie_stream, MAH_ERROR_INVALID_TIME_SIG);
+    }
+
+    uint64_t beat = timeline->resolution / (uint64_t) time_sig.denominator;
+    if (beat > UINT64_MAX / (uint64_t) time_sig.numerator)
+    {
+        RETURN_EMPTY_STRUCT_ERR(mah_tie_stream, MAH_ERROR_OVERFLOW_TIMELINE);
+    }
+
+    return (struct mah_tie_stream) {
+        .timeline = timeline,
+        .tuplets  = tuplets,
+        .split    = beats ? beat : beat * (uint64_t) time_sig.numerator,
+    };
+}
+
+void
+mah_split_notes(
+    struct mah_tie_stream* stream, struct mah_timed_note const notes[], int const num, struct mah_tied_list* list,
+    enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_SPLIT_NOTES);
+
+    if (num < 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return;
+    }
+
+    struct mah_timeline const* timeline = stream->timeline;
+    for (int i = 0; i < num; i++)
+    {
+        uint64_t ticks          = 0;
+        enum mah_error note_err = MAH_ERROR_NONE;
+        if (notes[i].duration >= MAH_DOTTED_WHOLE && notes[i].duration < MAH_TUPLET)
+        { // plain durations skip the lookup
+            ticks = timeline->ticks[notes[i].duration];
+        }
+        else
+        {
+            ticks = mah_get_timeline_ticks(timeline, &notes[i], &note_err);
+        }
+
+        uint64_t room = stream->split - stream->tick;
+        if (note_err == MAH_ERROR_NONE && ticks <= room)
+        { // fits before the next split point, so it is kept as written
+            add_tied_note(list, &notes[i], false, err);
+            stream->tick = ticks == room ? 0 : stream->tick + ticks;
+            continue;
+        }
+        if (note_err == MAH_ERROR_NONE)
+        {
+            note_err = split_across(stream, &notes[i], ticks, list, err);
+        }
+        if (note_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(note_err);
+            return;
+        }
+    }
+}
+
+// Tempo maps //
+
+void
+mah_get_tempo_map(
+    struct mah_tempo_map* map, struct mah_tempo_change const changes[], int const num, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_GET_TEMPO_MAP);
+
+    if (num <= 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_TEMPO);
+        return;
+    }
+
+    // every change is checked before the first point is written, so a failed call leaves map as it was
+    struct mah_tempo_point point = { 0 };
+    for (int c = 0; c < num; c++)
+    {
+        if (tempo_point(c > 0 ? &point : NULL, changes + c, &point) != MAH_ERROR_NONE)
+        {
+            SET_ERR(MAH_ERROR_INVALID_TEMPO);
+            return;
+        }
+    }
+
+    for (int c = 0; c < num; c++)
+    { // each point adds the tempo before it, so the seconds of every change are summed once
+        tempo_point(c > 0 ? map->points + c - 1 : NULL, changes + c, map->points + c);
+    }
+    map->num = num;
+}
+
+double
+mah_get_tempo_seconds(struct mah_tempo_map const* map, uint64_t const tick, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_TEMPO_SECONDS);
+
+    if (map->num <= 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_TEMPO);
+        return 0;
+    }
+    return point_seconds(map->points + tick_point(map, tick), tick);
+}
+
+uint64_t
+mah_get_tempo_tick(struct mah_tempo_map const* map, double const seconds, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_TEMPO_TICK);
+
+    uint64_t tick = 0;
+    if (map->num <= 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_TEMPO);
+        return 0;
+    }
+    enum mah_error tick_err = point_tick(map->points + seconds_point(map, seconds), seconds, &tick);
+    if (tick_err != MAH_ERROR_NONE)
+    {
+        SET_ERR(tick_err);
+        return 0;
+    }
+    return tick;
+}
+
+void
+mah_get_tempo_seconds_batch(
+    struct mah_tempo_map const* map, uint64_t const ticks[], int const num, double out[], enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_GET_TEMPO_SECONDS_BATCH);
+
+    if (num < 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return;
+    }
+    if (map->num <= 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_TEMPO);
+        return;
+    }
+
+    // ticks are sorted, so the point only moves forward and the whole batch is one merge
+    int p = 0;
+    for (int i = 0; i < num; i++)
+    {
+        if (i > 0 && ticks[i] < ticks[i - 1])
+        {
+            SET_ERR(MAH_ERROR_INVALID_RANGE);
+            return;
+        }
+        while (p + 1 < map->num && map->points[p + 1].tick <= ticks[i])
+        {
+            p++;
+        }
+        out[i] = point_seconds(map->points + p, ticks[i]);
+    }
+}
+
+void
+mah_get_tempo_ticks_batch(
+    struct mah_tempo_map const* map, double const seconds[], int const num, uint64_t out[], enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_GET_TEMPO_TICKS_BATCH);
+
+    if (num < 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_RANGE);
+        return;
+    }
+    if (map->num <= 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_TEMPO);
+        return;
+    }
+
+    int p = 0;
+    for (int i = 0; i < num; i++)
+    {
+        enum mah_error tick_err = MAH_ERROR_NONE;
+        if (i > 0 && seconds[i] < seconds[i - 1])
+        {
+            tick_err = MAH_ERROR_INVALID_RANGE;
+        }
+        while (tick_err == MAH_ERROR_NONE && p + 1 < map->num && map->points[p + 1].seconds <= seconds[i])
+        {
+            p++;
+        }
+        if (tick_err == MAH_ERROR_NONE)
+        {
+            tick_err = point_tick(map->points + p, seconds[i], &out[i]);
+        }
+        if (tick_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(tick_err);
+            return;
+        }
+    }
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
 #ifndef __MAH_RHYTHM_H__
 #define __MAH_RHYTHM_H__
 
+#include "arena/arena.h"
 #include "err/err.h"
 #include "note/note.h"
+#include "pack/pack.h"
+#include "timeline/timeline.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // Structures //
 
@@ -12,9 +18,121 @@ typedef struct mah_time_sig
     int denominator;
 } mah_time_sig;
 
+typedef struct mah_time_change
+{
+    uint64_t measure;             // first measure in time_sig
+    struct mah_time_sig time_sig;
+} mah_time_change;
+
+typedef struct mah_measure_error
+{ // measure whose notes do not add up to its time signature
+    uint64_t measure; // index of measure in stream
+    uint64_t note;    // index of first note of measure in stream
+    uint64_t num;     // notes in measure
+    int64_t ticks;    // ticks of notes in measure
+    int64_t expected; // ticks of time signature
+} mah_measure_error;
+
+typedef struct mah_measure_list
+{
+    int max;
+    int size;
+    struct mah_measure_error* results;
+    struct mah_arena* arena; // grows results when full (optional)
+} mah_measure_list;
+
+typedef struct mah_measure_stream
+{ // state of mah_segment_measures between chunks of a stream
+    struct mah_time_change const* changes; // ascending by measure, first at measure 0
+    int num_changes;
+    int change;       // index of time signature in effect
+    uint64_t note;    // notes read so far
+    uint64_t measure; // index of open measure
+    uint64_t first;   // first note of open measure
+    int64_t ticks;    // ticks of open measure so far
+    int64_t expected; // ticks of a full measure in time signature in effect
+} mah_measure_stream;
+
+typedef struct mah_tied_note
+{
+    struct mah_timed_note note;
+    bool tie; // tied to the next note
+} mah_tied_note;
+
+typedef struct mah_tied_list
+{
+    int max;
+    int size;
+    struct mah_tied_note* results;
+    struct mah_arena* arena; // grows results when full (optional)
+} mah_tied_list;
+
+typedef struct mah_tie_stream
+{ // state of mah_split_notes between chunks of a stream
+    struct mah_timeline const* timeline; // ticks of notes, holding every tuplet of the stream
+    struct mah_tuplet_table* tuplets;    // tuplets of split tuplet notes, caller supplied
+    uint64_t split;                      // ticks between split points (a measure, or a beat)
+    uint64_t tick;                       // ticks since last split point
+} mah_tie_stream;
+
+typedef struct mah_tempo_change
+{
+    uint64_t tick; // first tick in tempo, at the scale of mah_get_duration_ticks
+    double bpm;    // quarter notes per minute
+} mah_tempo_change;
+
+typedef struct mah_tempo_point
+{ // start of a tempo in a tempo map
+    uint64_t tick;     // first tick in tempo
+    double seconds;    // seconds from tick 0 to tick
+    double per_tick;   // seconds per tick
+    double per_second; // ticks per second
+} mah_tempo_point;
+
+typedef struct mah_tempo_map
+{
+    struct mah_tempo_point* points; // one per tempo change, caller supplied
+    int num;
+} mah_tempo_map;
+
 // Functions //
 
 // Time signature and measure validation
 void mah_validate_measure(struct mah_timed_note* notes, int count, struct mah_time_sig time_sig, enum mah_error* err);
 
+// Streaming measure segmentation
+struct mah_measure_stream mah_start_measures(struct mah_time_change const changes[], int num, enum mah_error* err);
+void mah_segment_measures(
+    struct mah_measure_stream* stream, struct mah_timed_note const notes[], int num, struct mah_measure_list* list,
+    enum mah_error* err
+);
+void mah_end_measures(struct mah_measure_stream* stream, struct mah_measure_list* list, enum mah_error* err);
+void mah_validate_measure_batch(
+    struct mah_timed_note const notes[], size_t const offsets[], int num, struct mah_time_change const changes[],
+    int const change_offsets[], struct mah_measure_list lists[], int threads, enum mah_error* err
+);
+
+// Barline splitting and ties
+struct mah_tie_stream mah_start_ties(
+    struct mah_timeline const* timeline, struct mah_time_sig time_sig, bool beats, struct mah_tuplet_table* tuplets,
+    enum mah_error* err
+);
+void mah_split_notes(
+    struct mah_tie_stream* stream, struct mah_timed_note const notes[], int num, struct mah_tied_list* list,
+    enum mah_error* err
+);
+
+// Tempo maps
+void mah_get_tempo_map(
+    struct mah_tempo_map* map, struct mah_tempo_change const changes[], int num, enum mah_error* err
+);
+double mah_get_tempo_seconds(struct mah_tempo_map const* map, uint64_t tick, enum mah_error* err);
+uint64_t mah_get_tempo_tick(struct mah_tempo_map const* map, double seconds, enum mah_error* err);
+void mah_get_tempo_seconds_batch(
+    struct mah_tempo_map const* map, uint64_t const ticks[], int num, double out[], enum mah_error* err
+);
+void mah_get_tempo_ticks_batch(
+    struct mah_tempo_map const* map, double const seconds[], int num, uint64_t out[], enum mah_error* err
+);
+
 #endif
\ No newline at end of file
@@ -7,8 +7,10 @@ Includes definition of preset scales
 */
 
 #include "scale/scale.h"
+#include "pool/pool.h"
 #include "shared/shared.h"
 #include <stdbool.h>
+#include <string.h>
 
 // Preset Scales //
 
@@ -114,6 +116,7 @@ struct mah_scale_base const MAH_WHOLE_TONE_SCALE = {
         { 2, MAH_MAJOR },
         { 2, MAH_MAJOR },
         { 3, MAH_DIMINISHED },
+        { 2, MAH_MAJOR },
     },
 };
 
@@ -147,6 +150,114 @@ struct mah_scale_base const MAH_OCTATONIC_WHOLE_SCALE = {
     },
 };
 
+// Macros //
+
+#define SCALE_BATCH_MIN 2048 // queries per thread of mah_return_scale_batch, fewer cost less than starting it
+
+// Global Variables //
+
+static struct mah_scale_base const* SCALE_POS[] = {
+    // Default scale list for return functions
+    &MAH_MAJOR_SCALE,
+    &MAH_NATURAL_MIN_SCALE,
+    &MAH_HARMONIC_MIN_SCALE,
+    &MAH_MELODIC_MIN_SCALE,
+};
+
+// Structures //
+
+struct scale_batch
+{ // shared by the workers of mah_return_scale_batch
+    struct mah_note const* notes;
+    int const* offsets;
+    struct mah_scale_result_list* lists;
+    struct mah_scale_index const* index;
+    struct pool_fail fails[MAH_THREADS_MAX];
+};
+
+// Internal Functions //
+
+static void
+return_scale_task(void* ctx, int const begin, int const end, int const worker)
+{ // each query only writes its own list, so results do not depend on the schedule
+    struct scale_batch* batch = ctx;
+    for (int q = begin; q < end; q++)
+    {
+        enum mah_error query_err = MAH_ERROR_NONE;
+        int first                = batch->offsets[q];
+        mah_return_scale_index(
+            batch->notes + first, batch->offsets[q + 1] - first, &batch->lists[q], batch->index, &query_err
+        );
+        pool_set_fail(&batch->fails[worker], q, query_err);
+    }
+}
+
+static enum mah_error
+scale_mask(struct mah_scale_base const* scale, mah_pitch_set* mask)
+{ // pitch class set of scale on C, walking the steps like mah_get_scale without a note buffer
+    struct mah_note note = { .tone = MAH_C, .acci = MAH_NATURAL };
+    *mask                = to_pitch_set(&note, 1);
+    for (int i = 1; i < scale->size; i++)
+    {
+        enum mah_error inter_err = MAH_ERROR_NONE;
+
+        note = mah_get_inter(note, scale->steps[i - 1], &inter_err);
+        if (inter_err != MAH_ERROR_NONE)
+        {
+            return inter_err;
+        }
+        if (i < scale->size - 1)
+        { // - 1 b/c size includes end note
+            *mask |= to_pitch_set(&note, 1);
+        }
+    }
+    return MAH_ERROR_NONE;
+}
+
+static void
+return_scales(
+    struct mah_note const notes[], int const num, struct mah_scale_result_list* list,
+    struct mah_scale_base const* const* pos, int const size, mah_pitch_set const* masks, enum mah_error* err
+)
+{ // matches notes against pos, using masks if compiled or building each mask on the stack
+    mah_pitch_set set = to_pitch_set(notes, num);
+    int set_size      = count_pitch_set(set);
+    for (int s = 0; s < size; s++)
+    {
+        if (pos[s]->size - 1 < num)
+        { // - 1 b/c size includes end note
+            continue;
+        }
+
+        mah_pitch_set mask = 0;
+        if (masks != NULL)
+        {
+            mask = masks[s];
+        }
+        else
+        {
+            enum mah_error scale_err = scale_mask(pos[s], &mask);
+            if (scale_err != MAH_ERROR_NONE)
+            {
+                SET_ERR(scale_err);
+                return;
+            }
+        }
+
+        if (count_pitch_set(mask) < set_size)
+        { // too few pitch classes to contain notes
+            continue;
+        }
+        for (int d = 0; d < SIZE_CHROMATIC; d++)
+        { // match every scale by rotating it up d semitones
+            if (IS_PITCH_SUBSET(set, ROTATE_PITCH_SET(mask, d)))
+            {
+                ADD_MATCHING_RESULT(MAH_ERROR_OVERFLOW_SCALE_RETURN, mah_scale_result, pos[s]);
+            }
+        }
+    }
+}
+
 // Functions //
 
 struct mah_scale
@@ -155,6 +266,8 @@ mah_get_scale(
     enum mah_scale_type const mode, enum mah_error* err
 )
 {
+    PROFILE(MAH_STATS_GET_SCALE);
+
     int size     = type->size;
     int ret_size = size;
     switch (mode)
@@ -201,52 +314,137 @@ mah_get_scale(
 
 void
 mah_return_scale(
-    struct mah_note const notes[], int const num, struct mah_scale_result_list* list, struct mah_scale_check* custom,
-    enum mah_error* err
+    struct mah_note const notes[], int const num, struct mah_scale_result_list* list,
+    struct mah_scale_check const* custom, enum mah_error* err
 )
 {
-    static struct mah_scale_base const* scale_pos[] = {
-        &MAH_MAJOR_SCALE,
-        &MAH_NATURAL_MIN_SCALE,
-        &MAH_HARMONIC_MIN_SCALE,
-        &MAH_MELODIC_MIN_SCALE,
-    };
-    struct mah_scale_check* scale_list = custom ? custom
-                                                : &(struct mah_scale_check) {
-                                                      .pos   = scale_pos,
-                                                      .notes = (struct mah_note[8]) { 0 },
-                                                      .size  = sizeof(scale_pos) / sizeof(*scale_pos),
-                                                  };
-
-    bool* semi = scale_list->semi;
-    for (int s = 0; s < scale_list->size; s++)
+    PROFILE(MAH_STATS_RETURN_SCALE);
+
+    if (custom == NULL)
     {
-        if (scale_list->pos[s]->size - 1 < num)
-        { // - 1 b/c size includes end note
-            continue;
-        }
+        return_scales(notes, num, list, SCALE_POS, sizeof(SCALE_POS) / sizeof(*SCALE_POS), NULL, err);
+        return;
+    }
+    return_scales(notes, num, list, custom->pos, custom->size, NULL, err);
+}
 
-        enum mah_error scale_err = MAH_ERROR_NONE;
-        struct mah_scale base      = mah_get_scale(
-            (struct mah_note) {
-                     .tone = MAH_C,
-                     .acci = MAH_NATURAL,
-            },
-            scale_list->pos[s], scale_list->notes, MAH_ASCEND, &scale_err
-        );
+void
+mah_get_scale_dict(struct mah_scale_dict* dict, struct mah_scale_check const* custom, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_SCALE_DICT);
+
+    dict->pos  = custom ? custom->pos : SCALE_POS;
+    dict->size = custom ? custom->size : (int) (sizeof(SCALE_POS) / sizeof(*SCALE_POS));
+    if (dict->size > dict->max)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_SCALE_DICT);
+        return;
+    }
+
+    for (int s = 0; s < dict->size; s++)
+    {
+        enum mah_error scale_err = scale_mask(dict->pos[s], &dict->masks[s]);
         if (scale_err != MAH_ERROR_NONE)
         {
             SET_ERR(scale_err);
             return;
         }
+    }
+}
 
-        fill_semi_table(semi, base.notes, base.size - 1);
+void
+mah_return_scale_dict(
+    struct mah_note const notes[], int const num, struct mah_scale_result_list* list,
+    struct mah_scale_dict const* dict, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_RETURN_SCALE_DICT);
+
+    return_scales(notes, num, list, dict->pos, dict->size, dict->masks, err);
+}
+
+void
+mah_get_scale_index(struct mah_scale_index* index, struct mah_scale_check const* custom, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_SCALE_INDEX);
+
+    index->pos   = custom ? custom->pos : SCALE_POS;
+    index->size  = custom ? custom->size : (int) (sizeof(SCALE_POS) / sizeof(*SCALE_POS));
+    index->words = MAH_SCALE_INDEX_WORDS(index->size) / MAH_PITCH_SETS;
+    if (index->words * MAH_PITCH_SETS > index->max)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_SCALE_INDEX);
+        return;
+    }
+    memset(index->bits, 0, sizeof(*index->bits) * index->words * MAH_PITCH_SETS);
+
+    for (int s = 0; s < index->size; s++)
+    {
+        mah_pitch_set mask       = 0;
+        enum mah_error scale_err = scale_mask(index->pos[s], &mask);
+        if (scale_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(scale_err);
+            return;
+        }
         for (int d = 0; d < SIZE_CHROMATIC; d++)
-        { // match every scale by semitone
-            if (has_shifted_matches(notes, num, semi, d))
+        { // (scale, root) pair is bit s * 12 + d of every subset the scale contains
+            int bit             = s * SIZE_CHROMATIC + d;
+            mah_pitch_set scale = ROTATE_PITCH_SET(mask, d);
+            for (mah_pitch_set sub = scale;; sub = (sub - 1) & scale)
+            {
+                index->bits[sub * index->words + bit / 64] |= (uint64_t) 1 << (bit % 64);
+                if (sub == 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void
+mah_return_scale_index(
+    struct mah_note const notes[], int const num, struct mah_scale_result_list* list,
+    struct mah_scale_index const* index, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_RETURN_SCALE_INDEX);
+
+    uint64_t const* row = &index->bits[to_pitch_set(notes, num) * index->words];
+    for (int w = 0; w < index->words; w++)
+    {
+        for (uint64_t bits = row[w]; bits; bits &= bits - 1)
+        { // visit set bits lowest first, which keeps list then root order
+            int bit                           = w * 64 + lowest_set_bit(bits);
+            struct mah_scale_base const* scale = index->pos[bit / SIZE_CHROMATIC];
+            if (scale->size - 1 < num)
             {
-                ADD_MATCHING_RESULT(MAH_ERROR_OVERFLOW_SCALE_RETURN, mah_scale_result, scale_list->pos[s]);
+                continue;
             }
+
+            int d = bit % SIZE_CHROMATIC;
+            ADD_MATCHING_RESULT(MAH_ERROR_OVERFLOW_SCALE_RETURN, mah_scale_result, scale);
         }
     }
+}
+
+void
+mah_return_scale_batch(
+    struct mah_note const notes[], int const offsets[], int const num, struct mah_scale_result_list lists[],
+    struct mah_scale_index const* index, int const threads, enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_RETURN_SCALE_BATCH);
+
+    struct scale_batch batch = { .notes = notes, .offsets = offsets, .lists = lists, .index = index };
+    int workers              = pool_workers(threads, num, SCALE_BATCH_MIN);
+    pool_start_fails(batch.fails, workers);
+    pool_run(workers, num, return_scale_task, &batch);
+
+    enum mah_error batch_err = pool_first_fail(batch.fails, workers);
+    if (batch_err != MAH_ERROR_NONE)
+    {
+        SET_ERR(batch_err);
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef __MAH_SCL_H__
 #define __MAH_SCL_H__
 
+#include "arena/arena.h"
 #include "err/err.h"
 #include "inter/inter.h"
 #include "note/note.h"
@@ -42,16 +43,36 @@ typedef struct mah_scale_result_list
     int max;
     int size;
     struct mah_scale_result* results;
+    struct mah_arena* arena; // grows results when full (optional)
 } mah_scale_result_list;
 
 typedef struct mah_scale_check
 {
     struct mah_scale_base const** pos;
     int size;
-    struct mah_note* notes;
-    bool semi[SIZE_CHROMATIC];
 } mah_scale_check;
 
+typedef struct mah_scale_dict
+{ // compiled scale list, read only once built
+    struct mah_scale_base const** pos;
+    int size;
+    int max;
+    mah_pitch_set* masks;
+} mah_scale_dict;
+
+typedef struct mah_scale_index
+{
+    struct mah_scale_base const** pos;
+    int size;
+    int max;
+    int words;
+    uint64_t* bits;
+} mah_scale_index;
+
+// Macros //
+
+#define MAH_SCALE_INDEX_WORDS(size) (MAH_PITCH_SETS * (((size) * SIZE_CHROMATIC + 63) / 64)) // bits size for index
+
 // Predefined Scales //
 
 extern struct mah_scale_base const MAH_MAJOR_SCALE;           // Major Scale
@@ -72,8 +93,22 @@ struct mah_scale mah_get_scale(
     enum mah_error* err
 );
 void mah_return_scale(
-    struct mah_note const notes[], int num, struct mah_scale_result_list* list, struct mah_scale_check* custom,
+    struct mah_note const notes[], int num, struct mah_scale_result_list* list, struct mah_scale_check const* custom,
+    enum mah_error* err
+);
+void mah_get_scale_dict(struct mah_scale_dict* dict, struct mah_scale_check const* custom, enum mah_error* err);
+void mah_return_scale_dict(
+    struct mah_note const notes[], int num, struct mah_scale_result_list* list, struct mah_scale_dict const* dict,
+    enum mah_error* err
+);
+void mah_get_scale_index(struct mah_scale_index* index, struct mah_scale_check const* custom, enum mah_error* err);
+void mah_return_scale_index(
+    struct mah_note const notes[], int num, struct mah_scale_result_list* list, struct mah_scale_index const* index,
     enum mah_error* err
 );
+void mah_return_scale_batch(
+    struct mah_note const notes[], int const offsets[], int num, struct mah_scale_result_list lists[],
+    struct mah_scale_index const* index, int threads, enum mah_error* err
+);
 
 #endif
\ No newline at end of file
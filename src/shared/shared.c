@@ -1,10 +1,21 @@
 #include "shared/shared.h"
-#include <stdlib.h>
+#include "pack/pack.h"
+#include <string.h>
 
 // Macros //
 
 #define SEMITONE_E 4 // semitone conversion of E
 
+// Global Variables //
+
+int const DUR_NUM[MAH_TUPLET]   = { 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 1, 1 };
+int const DUR_SHIFT[MAH_TUPLET] = { 1, 0, 2, 1, 3, 2, 4, 3, 5, 4, 6, 5, 6, 7 };
+
+static char const DISP_NOTE[]              = "CDEFGAB";
+static char const DISP_ACCI[][5]           = { "bbbb", "bbb", "bb", "b", "", "#", "##", "###", "####" };
+static unsigned char const DISP_ACCI_LEN[] = { 4, 3, 2, 1, 0, 1, 2, 3, 4 };
+static signed char const READ_TONE[]       = { MAH_A, MAH_B, MAH_C, MAH_D, MAH_E, MAH_F, MAH_G }; // 'A' to 'G'
+
 // Functions //
 
 int
@@ -23,7 +34,8 @@ to_semitone_adj(struct mah_note note)
 int
 constrain_semitone(int semi)
 {
-    return semi < 0 ? SIZE_CHROMATIC - (abs(semi) % SIZE_CHROMATIC) : semi % SIZE_CHROMATIC; // constrain from 0 -> 11
+    int constrained = semi % SIZE_CHROMATIC;
+    return constrained < 0 ? constrained + SIZE_CHROMATIC : constrained; // constrain from 0 -> 11
 }
 
 struct mah_note
@@ -35,30 +47,132 @@ from_semitone(int semi)
     };
 }
 
-void
-fill_semi_table(bool* semi, struct mah_note* notes, int size)
+mah_pitch_set
+to_pitch_set(struct mah_note const notes[], int const size)
 {
-    for (int i = 0; i < SIZE_CHROMATIC; i++)
+    mah_pitch_set set = 0;
+    for (int n = 0; n < size; n++)
     {
-        semi[i] = false;
+        set |= 1 << to_semitone_adj(notes[n]);
     }
-    for (int n = 0; n < size; n++)
+    return set;
+}
+
+int
+count_pitch_set(mah_pitch_set set)
+{
+#if defined(__GNUC__)
+    return __builtin_popcount(set);
+#else
+    int count = 0;
+    for (; set; set &= set - 1) // clear lowest bit until empty
     {
-        semi[to_semitone_adj(notes[n])] = true;
+        count++;
     }
+    return count;
+#endif
 }
 
-bool
-has_shifted_matches(struct mah_note const notes[], int num, bool* semi, int shift)
+int
+lowest_set_bit(uint64_t bits) // bits must not be 0
 {
-    for (int n = 0; n < num; n++)
-    { // instead of shifting scale up to match, shift semitones down
-        if (!semi[constrain_semitone(to_semitone_adj(notes[n]) - shift)])
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int low = 0;
+    for (; !(bits & 1); bits >>= 1)
+    {
+        low++;
+    }
+    return low;
+#endif
+}
+
+int
+find_tuplet(struct mah_tuplet_table* table, struct mah_tuplet const* tuplet, enum mah_error* err)
+{ // returns index + 1 of equal tuplet in table, adding it if needed (0 on error)
+    if (tuplet == NULL)
+    {
+        SET_ERR(MAH_ERROR_INVALID_TUPLET);
+        return 0;
+    }
+    if (table == NULL)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_TUPLET_TABLE);
+        return 0;
+    }
+
+    for (int i = 0; i < table->size; i++)
+    {
+        struct mah_tuplet const* entry = table->tuplets + i;
+        if (entry->n == tuplet->n && entry->m == tuplet->m && entry->base == tuplet->base)
+        {
+            return i + 1;
+        }
+    }
+
+    if (table->size == table->max || table->size == MAH_TUPLET_TABLE_MAX)
+    {
+        SET_ERR(MAH_ERROR_OVERFLOW_TUPLET_TABLE);
+        return 0;
+    }
+    table->tuplets[table->size++] = *tuplet;
+    return table->size;
+}
+
+enum mah_error
+check_print_note(struct mah_note const note)
+{ // same limits as the tone and accidental tables
+    if (note.acci < -4 || note.acci > 4)
+    {
+        return MAH_ERROR_INVALID_PRINT_QUAL;
+    }
+    if (note.tone < MAH_C || note.tone > MAH_B)
+    {
+        return MAH_ERROR_INVALID_PRINT_NOTE;
+    }
+    return MAH_ERROR_NONE;
+}
+
+size_t
+write_pitch(struct mah_note const note, char out[]) // note must pass check_print_note
+{ // tone and accidentals without null terminating, at most 5 chars
+    out[0] = DISP_NOTE[note.tone];
+    memcpy(out + 1, DISP_ACCI[note.acci + 4], DISP_ACCI_LEN[note.acci + 4]);
+    return 1 + DISP_ACCI_LEN[note.acci + 4];
+}
+
+size_t
+read_pitch(char const text[], size_t const len, struct mah_note* note)
+{ // inverse of write_pitch, returns bytes read or 0 if text does not start with a tone
+    if (len == 0 || text[0] < 'A' || text[0] > 'G')
+    {
+        return 0;
+    }
+    note->tone = READ_TONE[text[0] - 'A'];
+    note->acci = 0;
+
+    size_t pos = 1;
+    if (pos < len && (text[pos] == '#' || text[pos] == 'b'))
+    { // run of one kind, same limit as write_pitch
+        char acci = text[pos];
+        while (pos < len && text[pos] == acci && pos <= 4)
         {
-            return false;
+            pos++;
         }
+        if (pos < len && text[pos] == acci)
+        {
+            return 0;
+        }
+        note->acci = acci == '#' ? (int) pos - 1 : 1 - (int) pos;
     }
-    return true;
+    return pos;
+}
+
+bool
+is_text_sep(char const c)
+{ // whitespace or comma
+    return c == ' ' || c == ',' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
 }
 
 struct mah_note
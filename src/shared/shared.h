@@ -1,9 +1,16 @@
 #ifndef __MAH_SHARED_H__
 #define __MAH_SHARED_H__
 
+#include "arena/arena.h"
 #include "err/err.h"
 #include "note/note.h"
+#include "stats/stats.h"
 #include <stdbool.h>
+#include <stdint.h>
+
+// Types //
+
+typedef uint16_t mah_pitch_set; // pitch class set, bit n is set if semitone n (C = 0) is present
 
 // Enums //
 
@@ -15,24 +22,63 @@ typedef enum mah_inversion_type
 
 // Macros //
 
-#define SIZE_CHROMATIC 12 // size of chromatic scale
+#define SIZE_CHROMATIC 12  // size of chromatic scale
+#define PITCH_SET_FULL 0xFFF // pitch class set containing all 12 semitones
+#define MAH_PITCH_SETS 4096  // number of distinct pitch class sets
+#define RESULTS_GROW_MIN 8   // results allocated when an empty list first grows into its arena
+#define MAH_THREADS_MAX 64   // most threads used by the batch functions
+#define WHOLE_TICKS 1920     // ticks of a whole note, as returned by mah_get_duration_ticks
+
+#define SEMITONE(tone) ((tone) * 2 - ((tone) > MAH_E)) // semitones of tone (or simple interval) above C
+
+// Rotates pitch class set up by shift semitones (shift must be 0 -> 11)
+#define ROTATE_PITCH_SET(set, shift)                                                                                   \
+    ((mah_pitch_set) ((((set) << (shift)) | ((set) >> (SIZE_CHROMATIC - (shift)))) & PITCH_SET_FULL))
+
+// Ticks of plain duration dur (before MAH_TUPLET) when a whole note is whole ticks (a multiple of 128)
+#define DUR_TICKS(dur, whole) (((whole) >> DUR_SHIFT[dur]) * DUR_NUM[dur])
+
+// True if every pitch class of sub is also in set
+#define IS_PITCH_SUBSET(sub, set) (((sub) & ~(set)) == 0)
+
+// Asserts following loop has no dependencies between iterations (output may alias input at the same index)
+#if defined(__clang__)
+#define VECTORIZE_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define VECTORIZE_LOOP _Pragma("GCC ivdep")
+#else
+#define VECTORIZE_LOOP
+#endif
 
 // Adds enharmonic Result entries to list for return functions
 #define ADD_MATCHING_RESULT(err, type, match)                                                                          \
     do                                                                                                                 \
     {                                                                                                                  \
         struct mah_note ret = from_semitone(d);                                                                        \
-        RETURN_IF_OVERFLOW_ERR(err);                                                                                   \
-        list->results[list->size++] = (struct type) { ret, match };                                                    \
+        ADD_RESULT(err, (struct type) { ret, match });                                                                 \
         if (ret.acci != MAH_NATURAL)                                                                                   \
         {                                                                                                              \
-            RETURN_IF_OVERFLOW_ERR(err);                                                                               \
-            list->results[list->size++] = (struct type) { get_enharmonic(ret), match };                                \
+            ADD_RESULT(err, (struct type) { get_enharmonic(ret), match });                                             \
         }                                                                                                              \
         else if (ret.tone == MAH_B)                                                                                    \
+        {                                                                                                              \
+            ADD_RESULT(err, (struct type) { { MAH_C, MAH_FLAT }, match });                                             \
+        }                                                                                                              \
+    }                                                                                                                  \
+    while (0)
+
+// Adds result to list, only counting it if list has neither results nor arena
+#define ADD_RESULT(err, ...)                                                                                           \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (list->results == NULL && list->arena == NULL)                                                              \
+        {                                                                                                              \
+            list->size++;                                                                                              \
+        }                                                                                                              \
+        else                                                                                                           \
         {                                                                                                              \
             RETURN_IF_OVERFLOW_ERR(err);                                                                               \
-            list->results[list->size++] = (struct type) { { MAH_C, MAH_FLAT }, match };                                \
+            list->results[list->size++] = __VA_ARGS__;                                                                 \
         }                                                                                                              \
     }                                                                                                                  \
     while (0)
@@ -55,25 +101,86 @@ typedef enum mah_inversion_type
         return (struct type) { 0 };                                                                                    \
     } while (0)
 
-// Sets error if not null and list will overflow
+// Sets error if not null and list will overflow (after growing list into its arena, if any)
 #define RETURN_IF_OVERFLOW_ERR(err)                                                                                    \
     {                                                                                                                  \
         if (list->size == list->max)                                                                                   \
         {                                                                                                              \
-            SET_ERR(err);                                                                                              \
-            return;                                                                                                    \
+            void* grown = grow_results(list->results, &list->max, sizeof(*list->results), list->arena);                \
+            if (grown == NULL)                                                                                         \
+            {                                                                                                          \
+                SET_ERR(err);                                                                                          \
+                return;                                                                                                \
+            }                                                                                                          \
+            list->results = grown;                                                                                     \
         }                                                                                                              \
     }                                                                                                                  \
     while (0)
 
+// Profiling //
+
+#if defined(MAH_PROFILE)
+
+#if !defined(__GNUC__)
+#error "MAH_PROFILE requires GCC or Clang"
+#endif
+
+#define PROFILE_UNSET ((enum mah_error) - 1) // err not yet set by profiled function
+
+// Counted on exit of the enclosing function
+struct profile_scope
+{
+    enum mah_stats_func func;
+    uint64_t start;
+    enum mah_error* caller; // err given by the caller
+    enum mah_error err;     // err seen by the function
+};
+
+// Profiles enclosing function, redirecting err so errors are counted even if caller passed NULL
+#define PROFILE(func)                                                                                                  \
+    struct profile_scope profile_scope __attribute__((cleanup(profile_end))) = {                                       \
+        func, profile_now(), err, PROFILE_UNSET                                                                        \
+    };                                                                                                                 \
+    err = &profile_scope.err
+
+// Profiles enclosing function without err
+#define PROFILE_CALL(func)                                                                                             \
+    struct profile_scope profile_scope __attribute__((cleanup(profile_end))) = {                                       \
+        func, profile_now(), NULL, PROFILE_UNSET                                                                       \
+    }
+
+uint64_t profile_now(void);
+void profile_end(struct profile_scope const* scope);
+
+#else
+
+#define PROFILE(func)
+#define PROFILE_CALL(func)
+
+#endif
+
+// Global Variables //
+
+extern int const DUR_NUM[MAH_TUPLET];   // durations before MAH_TUPLET as fractions of a whole note
+extern int const DUR_SHIFT[MAH_TUPLET]; // their denominators are 1 << DUR_SHIFT
+
 // Functions //
 
+struct mah_tuplet_table; // defined in pack/pack.h
+
 int constrain_semitone(int semi);
 int to_semitone(int tone);
 struct mah_note from_semitone(int semi);
 int to_semitone_adj(struct mah_note note);
 struct mah_note get_enharmonic(struct mah_note note);
-void fill_semi_table(bool* semi, struct mah_note* notes, int size);
-bool has_shifted_matches(struct mah_note const notes[], int num, bool* semi, int shift);
+enum mah_error check_print_note(struct mah_note note);
+size_t write_pitch(struct mah_note note, char out[]);
+size_t read_pitch(char const text[], size_t len, struct mah_note* note);
+bool is_text_sep(char c);
+mah_pitch_set to_pitch_set(struct mah_note const notes[], int size);
+int count_pitch_set(mah_pitch_set set);
+int lowest_set_bit(uint64_t bits);
+void* grow_results(void* results, int* max, size_t elem, struct mah_arena* arena);
+int find_tuplet(struct mah_tuplet_table* table, struct mah_tuplet const* tuplet, enum mah_error* err);
 
 #endif
@@ -0,0 +1,194 @@
+/*
+
+| stats.c |
+Defines the counters recorded when built with MAH_PROFILE
+Counters are shared by all threads and updated with relaxed atomics
+
+*/
+
+#if defined(MAH_PROFILE)
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#endif
+
+#include "stats/stats.h"
+#include "shared/shared.h"
+#include <string.h>
+
+#if defined(MAH_PROFILE)
+#include <time.h>
+#endif
+
+// Global Variables //
+
+#if defined(MAH_PROFILE)
+static struct mah_stats STATS; // only uint64_t members, so it can be walked as an array
+#endif
+
+static char const* const NAMES[MAH_STATS_FUNCS] = {
+    [MAH_STATS_GET_INTER]                 = "mah_get_inter",
+    [MAH_STATS_RETURN_INTER]              = "mah_return_inter",
+    [MAH_STATS_GET_INTER_BATCH]           = "mah_get_inter_batch",
+    [MAH_STATS_RETURN_INTER_BATCH]        = "mah_return_inter_batch",
+    [MAH_STATS_GET_CHORD]                 = "mah_get_chord",
+    [MAH_STATS_RETURN_CHORD]              = "mah_return_chord",
+    [MAH_STATS_GET_CHORD_DICT]            = "mah_get_chord_dict",
+    [MAH_STATS_RETURN_CHORD_DICT]         = "mah_return_chord_dict",
+    [MAH_STATS_GET_CHORD_INDEX]           = "mah_get_chord_index",
+    [MAH_STATS_RETURN_CHORD_INDEX]        = "mah_return_chord_index",
+    [MAH_STATS_RETURN_CHORD_BATCH]        = "mah_return_chord_batch",
+    [MAH_STATS_INVERT_CHORD]              = "mah_invert_chord",
+    [MAH_STATS_READ_CHORD_SYMBOL]         = "mah_read_chord_symbol",
+    [MAH_STATS_WRITE_CHORD_SYMBOL]        = "mah_write_chord_symbol",
+    [MAH_STATS_GET_SCALE]                 = "mah_get_scale",
+    [MAH_STATS_RETURN_SCALE]              = "mah_return_scale",
+    [MAH_STATS_GET_SCALE_DICT]            = "mah_get_scale_dict",
+    [MAH_STATS_RETURN_SCALE_DICT]         = "mah_return_scale_dict",
+    [MAH_STATS_GET_SCALE_INDEX]           = "mah_get_scale_index",
+    [MAH_STATS_RETURN_SCALE_INDEX]        = "mah_return_scale_index",
+    [MAH_STATS_RETURN_SCALE_BATCH]        = "mah_return_scale_batch",
+    [MAH_STATS_GET_KEY_SIG]               = "mah_get_key_sig",
+    [MAH_STATS_RETURN_KEY_SIG]            = "mah_return_key_sig",
+    [MAH_STATS_GET_KEY_RELATIVE]          = "mah_get_key_relative",
+    [MAH_STATS_QUERY_ACCI]                = "mah_query_acci",
+    [MAH_STATS_APPLY_KEY_SIG_NOTES]       = "mah_apply_key_sig_notes",
+    [MAH_STATS_STRIP_KEY_SIG_NOTES]       = "mah_strip_key_sig_notes",
+    [MAH_STATS_APPLY_KEY_SIG_TIMED_NOTES] = "mah_apply_key_sig_timed_notes",
+    [MAH_STATS_STRIP_KEY_SIG_TIMED_NOTES] = "mah_strip_key_sig_timed_notes",
+    [MAH_STATS_APPLY_KEY_SIG_BATCH]       = "mah_apply_key_sig_batch",
+    [MAH_STATS_STRIP_KEY_SIG_BATCH]       = "mah_strip_key_sig_batch",
+    [MAH_STATS_WRITE_NOTE]                = "mah_write_note",
+    [MAH_STATS_WRITE_NOTES]               = "mah_write_notes",
+    [MAH_STATS_READ_NOTE]                 = "mah_read_note",
+    [MAH_STATS_READ_NOTES]                = "mah_read_notes",
+    [MAH_STATS_IS_ENHARMONIC]             = "mah_is_enharmonic",
+    [MAH_STATS_IS_ENHARMONIC_BATCH]       = "mah_is_enharmonic_batch",
+    [MAH_STATS_GET_DURATION_FRACTION]     = "mah_get_duration_fraction",
+    [MAH_STATS_GET_DURATION_TICKS]        = "mah_get_duration_ticks",
+    [MAH_STATS_COMPARE_DURATIONS]         = "mah_compare_durations",
+    [MAH_STATS_CREATE_TUPLET]             = "mah_create_tuplet",
+    [MAH_STATS_VALIDATE_MEASURE]          = "mah_validate_measure",
+    [MAH_STATS_GET_QUARTAL_CHORD]         = "mah_get_quartal_chord",
+    [MAH_STATS_GET_QUINTAL_CHORD]         = "mah_get_quintal_chord",
+    [MAH_STATS_INVERT_NONTERTIAN_CHORD]   = "mah_invert_nontertian_chord",
+    [MAH_STATS_FOLD_NONTERTIAN_CHORD]     = "mah_fold_nontertian_chord",
+    [MAH_STATS_PACK_NOTE]                 = "mah_pack_note",
+    [MAH_STATS_UNPACK_NOTE]               = "mah_unpack_note",
+    [MAH_STATS_PACK_NOTES]                = "mah_pack_notes",
+    [MAH_STATS_UNPACK_NOTES]              = "mah_unpack_notes",
+    [MAH_STATS_PACK_NOTE_BATCH]           = "mah_pack_note_batch",
+    [MAH_STATS_UNPACK_NOTE_BATCH]         = "mah_unpack_note_batch",
+    [MAH_STATS_PACK_TIMED_NOTE]           = "mah_pack_timed_note",
+    [MAH_STATS_UNPACK_TIMED_NOTE]         = "mah_unpack_timed_note",
+    [MAH_STATS_PACK_TIMED_NOTES]          = "mah_pack_timed_notes",
+    [MAH_STATS_UNPACK_TIMED_NOTES]        = "mah_unpack_timed_notes",
+    [MAH_STATS_ARENA_ALLOC]               = "mah_arena_alloc",
+    [MAH_STATS_READ_MIDI_FILE]            = "mah_read_midi_file",
+    [MAH_STATS_READ_MIDI_NOTES]           = "mah_read_midi_notes",
+    [MAH_STATS_GET_MIDI_NOTE]             = "mah_get_midi_note",
+    [MAH_STATS_WRITE_MIDI_FILE]           = "mah_write_midi_file",
+    [MAH_STATS_GET_MIDI_KEY]              = "mah_get_midi_key",
+    [MAH_STATS_WRITE_CORPUS]              = "mah_write_corpus",
+    [MAH_STATS_READ_CORPUS]               = "mah_read_corpus",
+    [MAH_STATS_GET_CORPUS_PIECE]          = "mah_get_corpus_piece",
+    [MAH_STATS_ENCODE_NOTES]              = "mah_encode_notes",
+    [MAH_STATS_DECODE_NOTES]              = "mah_decode_notes",
+    [MAH_STATS_GET_TIMELINE]              = "mah_get_timeline",
+    [MAH_STATS_GET_TIMELINE_TICKS]        = "mah_get_timeline_ticks",
+    [MAH_STATS_GET_TIMELINE_STARTS]       = "mah_get_timeline_starts",
+    [MAH_STATS_START_MEASURES]            = "mah_start_measures",
+    [MAH_STATS_SEGMENT_MEASURES]          = "mah_segment_measures",
+    [MAH_STATS_END_MEASURES]              = "mah_end_measures",
+    [MAH_STATS_VALIDATE_MEASURE_BATCH]    = "mah_validate_measure_batch",
+    [MAH_STATS_START_TIES]                = "mah_start_ties",
+    [MAH_STATS_SPLIT_NOTES]               = "mah_split_notes",
+    [MAH_STATS_GET_QUANT_TABLE]           = "mah_get_quant_table",
+    [MAH_STATS_QUANTIZE_NOTES]            = "mah_quantize_notes",
+    [MAH_STATS_GET_TEMPO_MAP]             = "mah_get_tempo_map",
+    [MAH_STATS_GET_TEMPO_SECONDS]         = "mah_get_tempo_seconds",
+    [MAH_STATS_GET_TEMPO_TICK]            = "mah_get_tempo_tick",
+    [MAH_STATS_GET_TEMPO_SECONDS_BATCH]   = "mah_get_tempo_seconds_batch",
+    [MAH_STATS_GET_TEMPO_TICKS_BATCH]     = "mah_get_tempo_ticks_batch",
+};
+
+// Internal Functions //
+
+#if defined(MAH_PROFILE)
+
+uint64_t
+profile_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+void
+profile_end(struct profile_scope const* scope)
+{
+    uint64_t ns                  = profile_now() - scope->start;
+    struct mah_func_stats* stats = STATS.funcs + scope->func;
+
+    int bucket = 63 - __builtin_clzll(ns | 1);
+    if (bucket >= MAH_STATS_BUCKETS)
+    {
+        bucket = MAH_STATS_BUCKETS - 1;
+    }
+    __atomic_fetch_add(&stats->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->total_ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->latency[bucket], 1, __ATOMIC_RELAXED);
+
+    if (scope->err == PROFILE_UNSET)
+    { // function never set err, leave caller's untouched
+        return;
+    }
+    if (scope->caller != NULL)
+    {
+        *scope->caller = scope->err;
+    }
+    if (scope->err != MAH_ERROR_NONE)
+    {
+        int code = scope->err < MAH_STATS_ERRORS ? (int) scope->err : MAH_STATS_ERRORS - 1;
+        __atomic_fetch_add(&stats->errors[code], 1, __ATOMIC_RELAXED);
+    }
+}
+
+#endif
+
+// Functions //
+
+void
+mah_stats_snapshot(struct mah_stats* stats)
+{
+#if defined(MAH_PROFILE)
+    uint64_t const* from = (uint64_t const*) &STATS;
+    uint64_t* to         = (uint64_t*) stats;
+    for (size_t i = 0; i < sizeof(STATS) / sizeof(uint64_t); i++)
+    {
+        to[i] = __atomic_load_n(from + i, __ATOMIC_RELAXED);
+    }
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+void
+mah_stats_reset(void)
+{
+#if defined(MAH_PROFILE)
+    uint64_t* counters = (uint64_t*) &STATS;
+    for (size_t i = 0; i < sizeof(STATS) / sizeof(uint64_t); i++)
+    {
+        __atomic_store_n(counters + i, 0, __ATOMIC_RELAXED);
+    }
+#endif
+}
+
+char const*
+mah_stats_name(enum mah_stats_func const func)
+{
+    if ((int) func < 0 || func >= MAH_STATS_FUNCS)
+    {
+        return "Unknown Function";
+    }
+    return NAMES[func];
+}
@@ -0,0 +1,123 @@
+#ifndef __MAH_STATS_H__
+#define __MAH_STATS_H__
+
+#include "err/err.h"
+#include <stdint.h>
+
+// Macros //
+
+#define MAH_STATS_ERRORS 64  // error codes counted per function (larger codes are counted in the last)
+#define MAH_STATS_BUCKETS 32 // latency buckets per function, bucket b counts calls of 2^b -> 2^(b+1) - 1 ns
+
+// Enums //
+
+typedef enum mah_stats_func
+{
+    MAH_STATS_GET_INTER,
+    MAH_STATS_RETURN_INTER,
+    MAH_STATS_GET_INTER_BATCH,
+    MAH_STATS_RETURN_INTER_BATCH,
+    MAH_STATS_GET_CHORD,
+    MAH_STATS_RETURN_CHORD,
+    MAH_STATS_GET_CHORD_DICT,
+    MAH_STATS_RETURN_CHORD_DICT,
+    MAH_STATS_GET_CHORD_INDEX,
+    MAH_STATS_RETURN_CHORD_INDEX,
+    MAH_STATS_RETURN_CHORD_BATCH,
+    MAH_STATS_INVERT_CHORD,
+    MAH_STATS_READ_CHORD_SYMBOL,
+    MAH_STATS_WRITE_CHORD_SYMBOL,
+    MAH_STATS_GET_SCALE,
+    MAH_STATS_RETURN_SCALE,
+    MAH_STATS_GET_SCALE_DICT,
+    MAH_STATS_RETURN_SCALE_DICT,
+    MAH_STATS_GET_SCALE_INDEX,
+    MAH_STATS_RETURN_SCALE_INDEX,
+    MAH_STATS_RETURN_SCALE_BATCH,
+    MAH_STATS_GET_KEY_SIG,
+    MAH_STATS_RETURN_KEY_SIG,
+    MAH_STATS_GET_KEY_RELATIVE,
+    MAH_STATS_QUERY_ACCI,
+    MAH_STATS_APPLY_KEY_SIG_NOTES,
+    MAH_STATS_STRIP_KEY_SIG_NOTES,
+    MAH_STATS_APPLY_KEY_SIG_TIMED_NOTES,
+    MAH_STATS_STRIP_KEY_SIG_TIMED_NOTES,
+    MAH_STATS_APPLY_KEY_SIG_BATCH,
+    MAH_STATS_STRIP_KEY_SIG_BATCH,
+    MAH_STATS_WRITE_NOTE,
+    MAH_STATS_WRITE_NOTES,
+    MAH_STATS_READ_NOTE,
+    MAH_STATS_READ_NOTES,
+    MAH_STATS_IS_ENHARMONIC,
+    MAH_STATS_IS_ENHARMONIC_BATCH,
+    MAH_STATS_GET_DURATION_FRACTION,
+    MAH_STATS_GET_DURATION_TICKS,
+    MAH_STATS_COMPARE_DURATIONS,
+    MAH_STATS_CREATE_TUPLET,
+    MAH_STATS_VALIDATE_MEASURE,
+    MAH_STATS_GET_QUARTAL_CHORD,
+    MAH_STATS_GET_QUINTAL_CHORD,
+    MAH_STATS_INVERT_NONTERTIAN_CHORD,
+    MAH_STATS_FOLD_NONTERTIAN_CHORD,
+    MAH_STATS_PACK_NOTE,
+    MAH_STATS_UNPACK_NOTE,
+    MAH_STATS_PACK_NOTES,
+    MAH_STATS_UNPACK_NOTES,
+    MAH_STATS_PACK_NOTE_BATCH,
+    MAH_STATS_UNPACK_NOTE_BATCH,
+    MAH_STATS_PACK_TIMED_NOTE,
+    MAH_STATS_UNPACK_TIMED_NOTE,
+    MAH_STATS_PACK_TIMED_NOTES,
+    MAH_STATS_UNPACK_TIMED_NOTES,
+    MAH_STATS_ARENA_ALLOC,
+    MAH_STATS_READ_MIDI_FILE,
+    MAH_STATS_READ_MIDI_NOTES,
+    MAH_STATS_GET_MIDI_NOTE,
+    MAH_STATS_WRITE_MIDI_FILE,
+    MAH_STATS_GET_MIDI_KEY,
+    MAH_STATS_WRITE_CORPUS,
+    MAH_STATS_READ_CORPUS,
+    MAH_STATS_GET_CORPUS_PIECE,
+    MAH_STATS_ENCODE_NOTES,
+    MAH_STATS_DECODE_NOTES,
+    MAH_STATS_GET_TIMELINE,
+    MAH_STATS_GET_TIMELINE_TICKS,
+    MAH_STATS_GET_TIMELINE_STARTS,
+    MAH_STATS_START_MEASURES,
+    MAH_STATS_SEGMENT_MEASURES,
+    MAH_STATS_END_MEASURES,
+    MAH_STATS_VALIDATE_MEASURE_BATCH,
+    MAH_STATS_START_TIES,
+    MAH_STATS_SPLIT_NOTES,
+    MAH_STATS_GET_QUANT_TABLE,
+    MAH_STATS_QUANTIZE_NOTES,
+    MAH_STATS_GET_TEMPO_MAP,
+    MAH_STATS_GET_TEMPO_SECONDS,
+    MAH_STATS_GET_TEMPO_TICK,
+    MAH_STATS_GET_TEMPO_SECONDS_BATCH,
+    MAH_STATS_GET_TEMPO_TICKS_BATCH,
+    MAH_STATS_FUNCS // number of profiled functions
+} mah_stats_func;
+
+// Structures //
+
+typedef struct mah_func_stats
+{
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t errors[MAH_STATS_ERRORS];
+    uint64_t latency[MAH_STATS_BUCKETS];
+} mah_func_stats;
+
+typedef struct mah_stats
+{
+    struct mah_func_stats funcs[MAH_STATS_FUNCS];
+} mah_stats;
+
+// Functions //
+
+void mah_stats_snapshot(struct mah_stats* stats);
+void mah_stats_reset(void);
+char const* mah_stats_name(enum mah_stats_func func);
+
+#endif
@@ -0,0 +1,189 @@
+/*
+
+| timeline.c |
+Defines the exact timeline of a score
+The resolution is a multiple of every duration and tuplet denominator, so ticks never round
+
+*/
+
+#include "timeline/timeline.h"
+#include "shared/shared.h"
+
+// Internal Functions //
+
+static uint64_t
+gcd_ticks(uint64_t a, uint64_t b)
+{
+    while (b != 0)
+    {
+        uint64_t rem = a % b;
+        a            = b;
+        b            = rem;
+    }
+    return a;
+}
+
+static enum mah_error
+tuplet_fraction(struct mah_tuplet const* tuplet, uint64_t* num, uint64_t* den)
+{ // reduced fraction of a whole note taken by one note of tuplet (n notes in the time of m base notes)
+    if (tuplet == NULL || tuplet->n <= 0 || tuplet->m <= 0 || tuplet->base < MAH_DOTTED_WHOLE ||
+        tuplet->base >= MAH_TUPLET)
+    {
+        return MAH_ERROR_INVALID_TUPLET;
+    }
+
+    uint64_t top    = (uint64_t) DUR_NUM[tuplet->base] * (uint64_t) tuplet->m;
+    uint64_t bottom = (UINT64_C(1) << DUR_SHIFT[tuplet->base]) * (uint64_t) tuplet->n;
+    uint64_t gcd    = gcd_ticks(top, bottom);
+    *num            = top / gcd;
+    *den            = bottom / gcd;
+    return MAH_ERROR_NONE;
+}
+
+static int
+lookup_tuplet(struct mah_tuplet_table const* table, struct mah_tuplet const* tuplet)
+{ // returns index + 1 of equal tuplet in table, 0 if missing
+    for (int i = 0; table != NULL && tuplet != NULL && i < table->size; i++)
+    {
+        struct mah_tuplet const* entry = table->tuplets + i;
+        if (entry->n == tuplet->n && entry->m == tuplet->m && entry->base == tuplet->base)
+        {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Functions //
+
+void
+mah_get_timeline(struct mah_timeline* timeline, struct mah_timed_note const notes[], int const num, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_TIMELINE);
+
+    for (int i = 0; i < num; i++)
+    { // first pass adds every tuplet of the score to the table
+        uint64_t top    = 0;
+        uint64_t bottom = 0;
+        if (notes[i].duration < MAH_DOTTED_WHOLE || notes[i].duration > MAH_TUPLET)
+        {
+            SET_ERR(MAH_ERROR_INVALID_DURATION);
+            return;
+        }
+        if (notes[i].duration != MAH_TUPLET)
+        {
+            continue;
+        }
+        enum mah_error tuplet_err = tuplet_fraction(notes[i].tuplet, &top, &bottom);
+        if (tuplet_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(tuplet_err);
+            return;
+        }
+        if (find_tuplet(timeline->tuplets, notes[i].tuplet, err) == 0)
+        {
+            return;
+        }
+    }
+
+    struct mah_tuplet_table const* table = timeline->tuplets;
+    int size                             = table ? table->size : 0;
+    uint64_t resolution                  = MAH_TIMELINE_BASE;
+    for (int t = 0; t < size; t++)
+    { // least common multiple of every denominator
+        uint64_t top              = 0;
+        uint64_t bottom           = 0;
+        enum mah_error tuplet_err = tuplet_fraction(table->tuplets + t, &top, &bottom);
+        if (tuplet_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(tuplet_err);
+            return;
+        }
+        uint64_t step = bottom / gcd_ticks(resolution, bottom);
+        if (resolution > UINT64_MAX / step)
+        {
+            SET_ERR(MAH_ERROR_OVERFLOW_TIMELINE);
+            return;
+        }
+        resolution *= step;
+    }
+
+    for (int t = 0; t < size; t++)
+    {
+        uint64_t top    = 0;
+        uint64_t bottom = 0;
+        tuplet_fraction(table->tuplets + t, &top, &bottom);
+        if (top > UINT64_MAX / (resolution / bottom))
+        {
+            SET_ERR(MAH_ERROR_OVERFLOW_TIMELINE);
+            return;
+        }
+        timeline->tuplet_ticks[t] = resolution / bottom * top;
+    }
+    for (int d = 0; d < MAH_TUPLET; d++)
+    {
+        timeline->ticks[d] = DUR_TICKS(d, resolution);
+    }
+    timeline->resolution = resolution;
+}
+
+uint64_t
+mah_get_timeline_ticks(struct mah_timeline const* timeline, struct mah_timed_note const* note, enum mah_error* err)
+{
+    PROFILE(MAH_STATS_GET_TIMELINE_TICKS);
+
+    if (note->duration < MAH_DOTTED_WHOLE || note->duration > MAH_TUPLET)
+    {
+        SET_ERR(MAH_ERROR_INVALID_DURATION);
+        return 0;
+    }
+    if (note->duration != MAH_TUPLET)
+    {
+        return timeline->ticks[note->duration];
+    }
+
+    int index = lookup_tuplet(timeline->tuplets, note->tuplet);
+    if (index == 0)
+    {
+        SET_ERR(MAH_ERROR_INVALID_TUPLET);
+        return 0;
+    }
+    return timeline->tuplet_ticks[index - 1];
+}
+
+uint64_t
+mah_get_timeline_starts(
+    struct mah_timeline const* timeline, struct mah_timed_note const notes[], int const num, uint64_t const start,
+    uint64_t out[], enum mah_error* err
+)
+{
+    PROFILE(MAH_STATS_GET_TIMELINE_STARTS);
+
+    uint64_t tick = start;
+    for (int i = 0; i < num; i++)
+    {
+        uint64_t ticks          = 0;
+        enum mah_error note_err = MAH_ERROR_NONE;
+        if (notes[i].duration >= MAH_DOTTED_WHOLE && notes[i].duration < MAH_TUPLET)
+        { // plain durations skip the lookup
+            ticks = timeline->ticks[notes[i].duration];
+        }
+        else
+        {
+            ticks = mah_get_timeline_ticks(timeline, &notes[i], &note_err);
+        }
+        if (note_err != MAH_ERROR_NONE)
+        {
+            SET_ERR(note_err);
+            return tick;
+        }
+        if (ticks > UINT64_MAX - tick)
+        {
+            SET_ERR(MAH_ERROR_OVERFLOW_TIMELINE);
+            return tick;
+        }
+        out[i] = tick;
+        tick += ticks;
+    }
+    return tick;
+}
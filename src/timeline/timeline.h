@@ -0,0 +1,34 @@
+#ifndef __MAH_TIMELINE_H__
+#define __MAH_TIMELINE_H__
+
+#include "err/err.h"
+#include "note/note.h"
+#include "pack/pack.h"
+#include <stdint.h>
+
+// Macros //
+
+#define MAH_TIMELINE_BASE 128 // resolution (ticks per whole note) of scores without tuplets
+
+// Structures //
+
+typedef struct mah_timeline
+{
+    uint64_t resolution;              // ticks per whole note
+    uint64_t ticks[MAH_TUPLET];       // ticks of each duration before MAH_TUPLET
+    struct mah_tuplet_table* tuplets; // tuplets of the score, caller supplied
+    uint64_t* tuplet_ticks;           // ticks of each tuplet in tuplets, caller supplied (tuplets->max entries)
+} mah_timeline;
+
+// Functions //
+
+void mah_get_timeline(struct mah_timeline* timeline, struct mah_timed_note const notes[], int num, enum mah_error* err);
+uint64_t mah_get_timeline_ticks(
+    struct mah_timeline const* timeline, struct mah_timed_note const* note, enum mah_error* err
+);
+uint64_t mah_get_timeline_starts(
+    struct mah_timeline const* timeline, struct mah_timed_note const notes[], int num, uint64_t start,
+    uint64_t out[], enum mah_error* err
+);
+
+#endif
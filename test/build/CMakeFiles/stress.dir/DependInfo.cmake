@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/arena/arena.c" "CMakeFiles/stress.dir/root/repo/src/arena/arena.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/arena/arena.c.o.d"
+  "/root/repo/src/chord/chord.c" "CMakeFiles/stress.dir/root/repo/src/chord/chord.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/chord/chord.c.o.d"
+  "/root/repo/src/corpus/corpus.c" "CMakeFiles/stress.dir/root/repo/src/corpus/corpus.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/corpus/corpus.c.o.d"
+  "/root/repo/src/err/err.c" "CMakeFiles/stress.dir/root/repo/src/err/err.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/err/err.c.o.d"
+  "/root/repo/src/inter/inter.c" "CMakeFiles/stress.dir/root/repo/src/inter/inter.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/inter/inter.c.o.d"
+  "/root/repo/src/key/key.c" "CMakeFiles/stress.dir/root/repo/src/key/key.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/key/key.c.o.d"
+  "/root/repo/src/midi/midi.c" "CMakeFiles/stress.dir/root/repo/src/midi/midi.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/midi/midi.c.o.d"
+  "/root/repo/src/misc/misc.c" "CMakeFiles/stress.dir/root/repo/src/misc/misc.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/misc/misc.c.o.d"
+  "/root/repo/src/nontertian/quartal.c" "CMakeFiles/stress.dir/root/repo/src/nontertian/quartal.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/nontertian/quartal.c.o.d"
+  "/root/repo/src/nontertian/quintal.c" "CMakeFiles/stress.dir/root/repo/src/nontertian/quintal.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/nontertian/quintal.c.o.d"
+  "/root/repo/src/note/note.c" "CMakeFiles/stress.dir/root/repo/src/note/note.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/note/note.c.o.d"
+  "/root/repo/src/pack/pack.c" "CMakeFiles/stress.dir/root/repo/src/pack/pack.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/pack/pack.c.o.d"
+  "/root/repo/src/pool/pool.c" "CMakeFiles/stress.dir/root/repo/src/pool/pool.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/pool/pool.c.o.d"
+  "/root/repo/src/quant/quant.c" "CMakeFiles/stress.dir/root/repo/src/quant/quant.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/quant/quant.c.o.d"
+  "/root/repo/src/rhythm/rhythm.c" "CMakeFiles/stress.dir/root/repo/src/rhythm/rhythm.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/rhythm/rhythm.c.o.d"
+  "/root/repo/src/scale/scale.c" "CMakeFiles/stress.dir/root/repo/src/scale/scale.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/scale/scale.c.o.d"
+  "/root/repo/src/shared/shared.c" "CMakeFiles/stress.dir/root/repo/src/shared/shared.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/shared/shared.c.o.d"
+  "/root/repo/src/stats/stats.c" "CMakeFiles/stress.dir/root/repo/src/stats/stats.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/stats/stats.c.o.d"
+  "/root/repo/src/timeline/timeline.c" "CMakeFiles/stress.dir/root/repo/src/timeline/timeline.c.o" "gcc" "CMakeFiles/stress.dir/root/repo/src/timeline/timeline.c.o.d"
+  "/root/repo/test/stress.c" "CMakeFiles/stress.dir/stress.c.o" "gcc" "CMakeFiles/stress.dir/stress.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
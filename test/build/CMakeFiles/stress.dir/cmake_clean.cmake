@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/stress.dir/root/repo/src/arena/arena.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/arena/arena.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/chord/chord.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/chord/chord.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/corpus/corpus.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/corpus/corpus.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/err/err.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/err/err.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/inter/inter.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/inter/inter.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/key/key.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/key/key.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/midi/midi.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/midi/midi.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/misc/misc.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/misc/misc.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/nontertian/quartal.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/nontertian/quartal.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/nontertian/quintal.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/nontertian/quintal.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/note/note.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/note/note.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/pack/pack.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/pack/pack.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/pool/pool.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/pool/pool.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/quant/quant.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/quant/quant.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/rhythm/rhythm.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/rhythm/rhythm.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/scale/scale.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/scale/scale.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/shared/shared.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/shared/shared.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/stats/stats.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/stats/stats.c.o.d"
+  "CMakeFiles/stress.dir/root/repo/src/timeline/timeline.c.o"
+  "CMakeFiles/stress.dir/root/repo/src/timeline/timeline.c.o.d"
+  "CMakeFiles/stress.dir/stress.c.o"
+  "CMakeFiles/stress.dir/stress.c.o.d"
+  "stress"
+  "stress.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/stress.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
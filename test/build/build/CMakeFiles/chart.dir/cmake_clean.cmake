@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chart.dir/ex/chart.c.o"
+  "CMakeFiles/chart.dir/ex/chart.c.o.d"
+  "chart"
+  "chart.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/chart.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
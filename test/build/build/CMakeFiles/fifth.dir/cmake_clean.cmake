@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fifth.dir/ex/fifth.c.o"
+  "CMakeFiles/fifth.dir/ex/fifth.c.o.d"
+  "fifth"
+  "fifth.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fifth.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,37 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/arena/arena.c" "build/CMakeFiles/mahler.dir/src/arena/arena.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/arena/arena.c.o.d"
+  "/root/repo/src/chord/chord.c" "build/CMakeFiles/mahler.dir/src/chord/chord.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/chord/chord.c.o.d"
+  "/root/repo/src/corpus/corpus.c" "build/CMakeFiles/mahler.dir/src/corpus/corpus.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/corpus/corpus.c.o.d"
+  "/root/repo/src/err/err.c" "build/CMakeFiles/mahler.dir/src/err/err.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/err/err.c.o.d"
+  "/root/repo/src/inter/inter.c" "build/CMakeFiles/mahler.dir/src/inter/inter.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/inter/inter.c.o.d"
+  "/root/repo/src/key/key.c" "build/CMakeFiles/mahler.dir/src/key/key.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/key/key.c.o.d"
+  "/root/repo/src/midi/midi.c" "build/CMakeFiles/mahler.dir/src/midi/midi.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/midi/midi.c.o.d"
+  "/root/repo/src/misc/misc.c" "build/CMakeFiles/mahler.dir/src/misc/misc.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/misc/misc.c.o.d"
+  "/root/repo/src/nontertian/quartal.c" "build/CMakeFiles/mahler.dir/src/nontertian/quartal.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/nontertian/quartal.c.o.d"
+  "/root/repo/src/nontertian/quintal.c" "build/CMakeFiles/mahler.dir/src/nontertian/quintal.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/nontertian/quintal.c.o.d"
+  "/root/repo/src/note/note.c" "build/CMakeFiles/mahler.dir/src/note/note.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/note/note.c.o.d"
+  "/root/repo/src/pack/pack.c" "build/CMakeFiles/mahler.dir/src/pack/pack.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/pack/pack.c.o.d"
+  "/root/repo/src/pool/pool.c" "build/CMakeFiles/mahler.dir/src/pool/pool.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/pool/pool.c.o.d"
+  "/root/repo/src/quant/quant.c" "build/CMakeFiles/mahler.dir/src/quant/quant.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/quant/quant.c.o.d"
+  "/root/repo/src/rhythm/rhythm.c" "build/CMakeFiles/mahler.dir/src/rhythm/rhythm.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/rhythm/rhythm.c.o.d"
+  "/root/repo/src/scale/scale.c" "build/CMakeFiles/mahler.dir/src/scale/scale.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/scale/scale.c.o.d"
+  "/root/repo/src/shared/shared.c" "build/CMakeFiles/mahler.dir/src/shared/shared.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/shared/shared.c.o.d"
+  "/root/repo/src/stats/stats.c" "build/CMakeFiles/mahler.dir/src/stats/stats.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/stats/stats.c.o.d"
+  "/root/repo/src/timeline/timeline.c" "build/CMakeFiles/mahler.dir/src/timeline/timeline.c.o" "gcc" "build/CMakeFiles/mahler.dir/src/timeline/timeline.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mahler.dir/src/arena/arena.c.o"
+  "CMakeFiles/mahler.dir/src/arena/arena.c.o.d"
+  "CMakeFiles/mahler.dir/src/chord/chord.c.o"
+  "CMakeFiles/mahler.dir/src/chord/chord.c.o.d"
+  "CMakeFiles/mahler.dir/src/corpus/corpus.c.o"
+  "CMakeFiles/mahler.dir/src/corpus/corpus.c.o.d"
+  "CMakeFiles/mahler.dir/src/err/err.c.o"
+  "CMakeFiles/mahler.dir/src/err/err.c.o.d"
+  "CMakeFiles/mahler.dir/src/inter/inter.c.o"
+  "CMakeFiles/mahler.dir/src/inter/inter.c.o.d"
+  "CMakeFiles/mahler.dir/src/key/key.c.o"
+  "CMakeFiles/mahler.dir/src/key/key.c.o.d"
+  "CMakeFiles/mahler.dir/src/midi/midi.c.o"
+  "CMakeFiles/mahler.dir/src/midi/midi.c.o.d"
+  "CMakeFiles/mahler.dir/src/misc/misc.c.o"
+  "CMakeFiles/mahler.dir/src/misc/misc.c.o.d"
+  "CMakeFiles/mahler.dir/src/nontertian/quartal.c.o"
+  "CMakeFiles/mahler.dir/src/nontertian/quartal.c.o.d"
+  "CMakeFiles/mahler.dir/src/nontertian/quintal.c.o"
+  "CMakeFiles/mahler.dir/src/nontertian/quintal.c.o.d"
+  "CMakeFiles/mahler.dir/src/note/note.c.o"
+  "CMakeFiles/mahler.dir/src/note/note.c.o.d"
+  "CMakeFiles/mahler.dir/src/pack/pack.c.o"
+  "CMakeFiles/mahler.dir/src/pack/pack.c.o.d"
+  "CMakeFiles/mahler.dir/src/pool/pool.c.o"
+  "CMakeFiles/mahler.dir/src/pool/pool.c.o.d"
+  "CMakeFiles/mahler.dir/src/quant/quant.c.o"
+  "CMakeFiles/mahler.dir/src/quant/quant.c.o.d"
+  "CMakeFiles/mahler.dir/src/rhythm/rhythm.c.o"
+  "CMakeFiles/mahler.dir/src/rhythm/rhythm.c.o.d"
+  "CMakeFiles/mahler.dir/src/scale/scale.c.o"
+  "CMakeFiles/mahler.dir/src/scale/scale.c.o.d"
+  "CMakeFiles/mahler.dir/src/shared/shared.c.o"
+  "CMakeFiles/mahler.dir/src/shared/shared.c.o.d"
+  "CMakeFiles/mahler.dir/src/stats/stats.c.o"
+  "CMakeFiles/mahler.dir/src/stats/stats.c.o.d"
+  "CMakeFiles/mahler.dir/src/timeline/timeline.c.o"
+  "CMakeFiles/mahler.dir/src/timeline/timeline.c.o.d"
+  "libmahler.a"
+  "libmahler.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/mahler.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/quartal.dir/ex/quartal.c.o"
+  "CMakeFiles/quartal.dir/ex/quartal.c.o.d"
+  "quartal"
+  "quartal.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/quartal.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
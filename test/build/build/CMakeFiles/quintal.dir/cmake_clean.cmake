@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/quintal.dir/ex/quintal.c.o"
+  "CMakeFiles/quintal.dir/ex/quintal.c.o.d"
+  "quintal"
+  "quintal.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/quintal.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
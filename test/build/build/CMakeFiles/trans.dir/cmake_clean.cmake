@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/trans.dir/ex/trans.c.o"
+  "CMakeFiles/trans.dir/ex/trans.c.o.d"
+  "trans"
+  "trans.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/trans.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -5,6 +5,7 @@
     The _ suffix represents the type it checks. See table below
     
     D   Default (two integer values)
+    F   double (equal to within 1e-9)
     ST  Null terminated String
     N   mah_note
     I   mah_interval
@@ -34,6 +35,7 @@
     NOTE_K       Takes in any number of notes to put as notes parameter of mah_key_sig
     NOTE_N       Creates mah_note buffer of size 1st, with the contents in 2nd
     NOTE_L       Creates empty mah_note buffer with any number of notes
+    NOTE_B       Creates note from index 2nd of mah_note_batch 1st
     INTER        Creates mah_interval with interval 1st and quality 2nd. No need for MAH prefix in 2nd
     INTER_L      Creates mah_interval buffer with any number of intervals
     CHORD        Creates mah_chord with size 1st, inversion 2nd, base 3rd, and notes 4th
@@ -45,10 +47,12 @@
     CHD_RES_L    Creates empty mah_chord_result buffer with size 1st
     CHD_RES_C    Creates mah_chord_result buffer with any number of notes
     CHD_RES_LIST Creates mah_chord_result_list with size max 1st, size 2nd, result 3rd
+    CHD_RES_LIST_A Same as CHD_RES_LIST with arena 4th
     SCL_RES      Creates mah_scale_result with note 1st, base 2nd
     SCL_RES_L    Creates empty mah_scale_result buffer with size 1st
     SCL_RES_C    Creates mah_scale_result buffer with any number of notes
     SCL_RES_LIST Creates mah_scale_result_list with size max 1st, size 2nd, result 3rd
+    SCL_RES_LIST_A Same as SCL_RES_LIST with arena 4th
     MAJOR_KEY    Same as MAH_MAJOR_KEY
     MINOR_KEY    Same as MAH_MINOR_KEY
     ASCEND       Same as MAH_ASCEND
@@ -71,6 +75,7 @@
 #define NOTE_K(...) {__VA_ARGS__}
 #define NOTE_N(size, ...) (struct mah_note[size]) {__VA_ARGS__}
 #define NOTE_L(...) (struct mah_note[]) {__VA_ARGS__}
+#define NOTE_B(batch, i) ((struct mah_note) {(batch).tone[i], (batch).acci[i], (batch).octave[i]})
 
 // Intervals //
 
@@ -123,6 +128,7 @@
 #define CHD_RES_L(size) (struct mah_chord_result[size]) {0}
 #define CHD_RES_C(...) (struct mah_chord_result[]) {__VA_ARGS__}
 #define CHD_RES_LIST(max, size, results) ((struct mah_chord_result_list) {max, size, results})
+#define CHD_RES_LIST_A(max, size, results, arena) ((struct mah_chord_result_list) {max, size, results, arena})
 
 // Scale //
 
@@ -141,6 +147,7 @@
 #define SCL_RES_L(size) (struct mah_scale_result[size]) {0}
 #define SCL_RES_C(...) (struct mah_scale_result[]) {__VA_ARGS__}
 #define SCL_RES_LIST(max, size, results) ((struct mah_scale_result_list) {max, size, results})
+#define SCL_RES_LIST_A(max, size, results, arena) ((struct mah_scale_result_list) {max, size, results, arena})
 
 #define ASCEND MAH_ASCEND
 #define DESCEND MAH_DESCEND
@@ -161,6 +168,10 @@
 
 // Rhythm testing macros //
 #define TIME_SIG(num, den) ((struct mah_time_sig) {num, den})
+#define ASSERT_F(act, exp) do {\
+    double assert_f_act = (act);\
+    ASSERT(fabs(assert_f_act - (exp)) < 1e-9, exp);\
+} while (0)
 
 // Nontertian chord testing macros //
 #define ASSERT_NCHD(act, exp) ASSERT(comp_nontertian_chord(act, exp) && (ERR == MAH_ERROR_NONE), exp)
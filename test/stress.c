@@ -0,0 +1,227 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mahler.h"
+
+// Calls the recognisers from many threads at once on shared read only input //
+/*
+    Every thread runs the same queries against one custom check, one dict and one index,
+    and compares each result with the serial result computed before the threads start.
+    Built with -fsanitize=thread when available (see CMakeLists.txt), where any race fails the run.
+*/
+
+#define STRESS_THREADS 8   // threads calling at once
+#define STRESS_ROUNDS 20   // passes over the queries per thread
+#define STRESS_QUERIES 100 // queries of 2 notes
+#define STRESS_RESULTS 48  // result buffer size
+#define STRESS_BATCH 4096  // queries of each batch (the same queries repeated), enough for batches to start workers
+#define STRESS_BATCHERS 2  // threads that also run batches
+
+// Structures //
+
+struct stress_expect
+{
+    struct mah_chord_result chords[STRESS_QUERIES][STRESS_RESULTS];
+    int chord_sizes[STRESS_QUERIES];
+    struct mah_scale_result scales[STRESS_QUERIES][STRESS_RESULTS];
+    int scale_sizes[STRESS_QUERIES];
+};
+
+struct stress_batch
+{
+    struct mah_chord_result chords[STRESS_BATCH][STRESS_RESULTS];
+    struct mah_chord_result_list chord_lists[STRESS_BATCH];
+    struct mah_scale_result scales[STRESS_BATCH][STRESS_RESULTS];
+    struct mah_scale_result_list scale_lists[STRESS_BATCH];
+};
+
+struct stress_thread
+{
+    int fails;
+    struct stress_batch* batch; // NULL for threads that do not run batches
+};
+
+// Global Variables //
+
+static struct mah_note NOTES[STRESS_BATCH * 2];
+static int OFFSETS[STRESS_BATCH + 1];
+
+static struct mah_chord_base const* CHORDS[] = {
+    &MAH_MAJOR_TRIAD, &MAH_MINOR_TRIAD, &MAH_DOMINANT_7, &MAH_MAJOR_7, &MAH_MINOR_7, &MAH_HALF_DIMINISHED_7,
+};
+static struct mah_scale_base const* SCALES[] = {
+    &MAH_MAJOR_SCALE, &MAH_NATURAL_MIN_SCALE, &MAH_PENTATONIC_MAJ_SCALE, &MAH_BLUES_SCALE,
+};
+
+static struct mah_chord_check const CHORD_CHECK = { CHORDS, sizeof(CHORDS) / sizeof(*CHORDS) };
+static struct mah_scale_check const SCALE_CHECK = { SCALES, sizeof(SCALES) / sizeof(*SCALES) };
+
+static struct mah_chord_dict CHORD_DICT = { 0, 0, sizeof(CHORDS) / sizeof(*CHORDS), (mah_pitch_set[6]) { 0 } };
+static struct mah_scale_dict SCALE_DICT = { 0, 0, sizeof(SCALES) / sizeof(*SCALES), (mah_pitch_set[4]) { 0 } };
+static struct mah_chord_index CHORD_INDEX;
+static struct mah_scale_index SCALE_INDEX = {
+    .max  = MAH_SCALE_INDEX_WORDS(4),
+    .bits = (uint64_t[MAH_SCALE_INDEX_WORDS(4)]) { 0 },
+};
+
+static struct stress_thread THREADS[STRESS_THREADS];
+static struct stress_batch BATCHES[STRESS_BATCHERS];
+
+static struct stress_expect EXPECT;
+
+// Internal Functions //
+
+static bool
+same_chords(struct mah_chord_result_list const* list, int const q)
+{
+    if (list->size != EXPECT.chord_sizes[q])
+    {
+        return false;
+    }
+    for (int i = 0; i < list->size; i++)
+    {
+        if (list->results[i].chord != EXPECT.chords[q][i].chord ||
+            memcmp(&list->results[i].key, &EXPECT.chords[q][i].key, sizeof(struct mah_note)) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+same_scales(struct mah_scale_result_list const* list, int const q)
+{
+    if (list->size != EXPECT.scale_sizes[q])
+    {
+        return false;
+    }
+    for (int i = 0; i < list->size; i++)
+    {
+        if (list->results[i].scale != EXPECT.scales[q][i].scale ||
+            memcmp(&list->results[i].key, &EXPECT.scales[q][i].key, sizeof(struct mah_note)) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void*
+stress(void* arg)
+{
+    struct stress_thread* thread = arg;
+    int* fails                   = &thread->fails;
+    struct mah_chord_result chords[STRESS_RESULTS];
+    struct mah_scale_result scales[STRESS_RESULTS];
+    for (int r = 0; r < STRESS_ROUNDS; r++)
+    {
+        for (int q = 0; q < STRESS_QUERIES; q++)
+        {
+            enum mah_error err                 = MAH_ERROR_NONE;
+            struct mah_note const* notes       = NOTES + OFFSETS[q];
+            struct mah_chord_result_list chord = { STRESS_RESULTS, 0, chords, NULL };
+            struct mah_scale_result_list scale = { STRESS_RESULTS, 0, scales, NULL };
+
+            mah_return_chord(notes, 2, &chord, &CHORD_CHECK, &err);
+            *fails += err != MAH_ERROR_NONE || !same_chords(&chord, q);
+            chord.size = 0;
+            mah_return_chord_dict(notes, 2, &chord, &CHORD_DICT, &err);
+            *fails += err != MAH_ERROR_NONE || !same_chords(&chord, q);
+            chord.size = 0;
+            mah_return_chord_index(notes, 2, &chord, &CHORD_INDEX, &err);
+            *fails += err != MAH_ERROR_NONE || !same_chords(&chord, q);
+
+            mah_return_scale(notes, 2, &scale, &SCALE_CHECK, &err);
+            *fails += err != MAH_ERROR_NONE || !same_scales(&scale, q);
+            scale.size = 0;
+            mah_return_scale_dict(notes, 2, &scale, &SCALE_DICT, &err);
+            *fails += err != MAH_ERROR_NONE || !same_scales(&scale, q);
+            scale.size = 0;
+            mah_return_scale_index(notes, 2, &scale, &SCALE_INDEX, &err);
+            *fails += err != MAH_ERROR_NONE || !same_scales(&scale, q);
+        }
+
+        // batches start their own workers from each thread
+        struct stress_batch* batch = thread->batch;
+        enum mah_error err         = MAH_ERROR_NONE;
+        for (int q = 0; batch != NULL && q < STRESS_BATCH; q++)
+        {
+            batch->chord_lists[q] = (struct mah_chord_result_list) { STRESS_RESULTS, 0, batch->chords[q], NULL };
+            batch->scale_lists[q] = (struct mah_scale_result_list) { STRESS_RESULTS, 0, batch->scales[q], NULL };
+        }
+        if (batch != NULL)
+        {
+            mah_return_chord_batch(NOTES, OFFSETS, STRESS_BATCH, batch->chord_lists, &CHORD_INDEX, 2, &err);
+            mah_return_scale_batch(NOTES, OFFSETS, STRESS_BATCH, batch->scale_lists, &SCALE_INDEX, 2, &err);
+        }
+        *fails += err != MAH_ERROR_NONE;
+        for (int q = 0; batch != NULL && q < STRESS_BATCH; q++)
+        {
+            *fails += !same_chords(&batch->chord_lists[q], q % STRESS_QUERIES) +
+                      !same_scales(&batch->scale_lists[q], q % STRESS_QUERIES);
+        }
+    }
+    return NULL;
+}
+
+// Functions //
+
+int
+main(void)
+{
+    enum mah_error err = MAH_ERROR_NONE;
+    for (int b = 0; b < STRESS_BATCH; b++)
+    { // same queries as the batch tests, repeated for the batches
+        int q            = b % STRESS_QUERIES;
+        NOTES[2 * b]     = (struct mah_note) { MAH_C + q % 7, (q / 7) % 3 - 1, MAH_OCTAVE_4 };
+        NOTES[2 * b + 1] = (struct mah_note) { MAH_C + (q + 2 + q / 21) % 7, (q / 3) % 3 - 1, MAH_OCTAVE_4 };
+        OFFSETS[b]       = 2 * b;
+    }
+    OFFSETS[STRESS_BATCH] = 2 * STRESS_BATCH;
+
+    // shared read only state, built once
+    mah_get_chord_dict(&CHORD_DICT, &CHORD_CHECK, &err);
+    mah_get_scale_dict(&SCALE_DICT, &SCALE_CHECK, &err);
+    mah_get_chord_index(&CHORD_INDEX, &CHORD_CHECK, &(enum mah_error) { 0 }); // count only
+    CHORD_INDEX.max     = CHORD_INDEX.size;
+    CHORD_INDEX.entries = malloc(sizeof(*CHORD_INDEX.entries) * CHORD_INDEX.max);
+    mah_get_chord_index(&CHORD_INDEX, &CHORD_CHECK, &err);
+    mah_get_scale_index(&SCALE_INDEX, &SCALE_CHECK, &err);
+    if (err != MAH_ERROR_NONE || CHORD_INDEX.entries == NULL)
+    {
+        fprintf(stderr, "stress setup failed: %s\n", mah_get_error(err));
+        return EXIT_FAILURE;
+    }
+
+    // serial expectations
+    for (int q = 0; q < STRESS_QUERIES; q++)
+    {
+        struct mah_chord_result_list chord = { STRESS_RESULTS, 0, EXPECT.chords[q], NULL };
+        struct mah_scale_result_list scale = { STRESS_RESULTS, 0, EXPECT.scales[q], NULL };
+        mah_return_chord(NOTES + OFFSETS[q], 2, &chord, &CHORD_CHECK, &err);
+        mah_return_scale(NOTES + OFFSETS[q], 2, &scale, &SCALE_CHECK, &err);
+        EXPECT.chord_sizes[q] = chord.size;
+        EXPECT.scale_sizes[q] = scale.size;
+    }
+
+    pthread_t threads[STRESS_THREADS];
+    for (int t = 0; t < STRESS_THREADS; t++)
+    {
+        THREADS[t].batch = t < STRESS_BATCHERS ? &BATCHES[t] : NULL;
+        pthread_create(&threads[t], NULL, stress, &THREADS[t]);
+    }
+    int total = 0;
+    for (int t = 0; t < STRESS_THREADS; t++)
+    {
+        pthread_join(threads[t], NULL);
+        total += THREADS[t].fails;
+    }
+
+    printf("%d threads x %d rounds, %d mismatches\n", STRESS_THREADS, STRESS_ROUNDS, total);
+    free(CHORD_INDEX.entries);
+    return total == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
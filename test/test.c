@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <math.h>
 
 #include "mahler.h"
 #include "macros.h"
@@ -16,11 +17,19 @@ struct Test {
 struct Test TEST = {0};
 enum mah_error ERR = MAH_ERROR_NONE;
 
+struct MidiNotes {
+    struct mah_midi_note notes[16];
+    int size;
+    int calls;
+};
+
 // Function Prototypes //
 
 void assert(int val, int line, char* file, char* expr);
 
 bool comp_note(struct mah_note note_a, struct mah_note note_b);
+bool comp_timed_note(struct mah_timed_note note_a, struct mah_timed_note note_b);
+bool comp_tied_notes(struct mah_tied_list list, struct mah_tied_note const* notes, int size);
 bool comp_notes(struct mah_note const* notes_a, struct mah_note const* notes_b, int size_a, int size_b);
 
 bool comp_interval(struct mah_interval inter_a, struct mah_interval inter_b);
@@ -42,6 +51,9 @@ bool comp_scale_base(struct mah_scale_base const* base_a, struct mah_scale_base
 
 bool comp_nontertian_chord(struct mah_nontertian_chord chord_a, struct mah_nontertian_chord chord_b);
 
+bool comp_midi_note(struct mah_midi_note note_a, struct mah_midi_note note_b);
+void collect_midi_notes(struct mah_midi_note const notes[], int num, void* ctx);
+
 int
 main(void)
 {
@@ -50,31 +62,75 @@ main(void)
     #include "suites/note/mah_duration.test"
     
     #include "suites/rhythm/mah_time_sig.test"
+    #include "suites/rhythm/mah_segment_measures.test"
+    #include "suites/rhythm/mah_validate_measure_batch.test"
+    #include "suites/rhythm/mah_split_notes.test"
+    #include "suites/rhythm/mah_get_tempo_map.test"
+    #include "suites/rhythm/mah_get_tempo_batch.test"
     
     #include "suites/inter/mah_return_inter.test"
     #include "suites/inter/mah_get_inter.test"
+    #include "suites/inter/mah_get_inter_batch.test"
+    #include "suites/inter/mah_return_inter_batch.test"
     
     #include "suites/key/mah_get_key_sig.test"
     #include "suites/key/mah_return_key_sig.test"
     #include "suites/key/mah_get_key_relative.test"
     #include "suites/key/mah_query_acci.test"
+    #include "suites/key/mah_apply_key_sig.test"
 
     #include "suites/misc/mah_is_enharmonic.test"
+    #include "suites/misc/mah_is_enharmonic_batch.test"
     #include "suites/misc/mah_write_note.test"
+    #include "suites/misc/mah_write_notes.test"
+    #include "suites/misc/mah_read_note.test"
+    #include "suites/misc/mah_read_notes.test"
     #include "suites/misc/mah_get_error.test" 
     
     #include "suites/chord/mah_invert_chord.test"
     #include "suites/chord/mah_get_chord.test"
     #include "suites/chord/mah_return_chord.test"
+    #include "suites/chord/mah_get_chord_index.test"
+    #include "suites/chord/mah_return_chord_index.test"
+    #include "suites/chord/mah_return_chord_batch.test"
+    #include "suites/chord/mah_return_chord_dict.test"
+    #include "suites/chord/mah_read_chord_symbol.test"
+    #include "suites/chord/mah_write_chord_symbol.test"
     
     #include "suites/scale/mah_get_scale.test"
     #include "suites/scale/mah_return_scale.test"
+    #include "suites/scale/mah_get_scale_index.test"
+    #include "suites/scale/mah_return_scale_index.test"
+    #include "suites/scale/mah_return_scale_batch.test"
+    #include "suites/scale/mah_return_scale_dict.test"
     
     #include "suites/nontertian/mah_get_quartal_chord.test"
     #include "suites/nontertian/mah_get_quintal_chord.test"
     #include "suites/nontertian/mah_invert_nontertian_chord.test"
     #include "suites/nontertian/mah_fold_nontertian_chord.test"
     
+    #include "suites/pack/mah_pack_note.test"
+    #include "suites/pack/mah_pack_notes.test"
+    #include "suites/pack/mah_pack_timed_note.test"
+    #include "suites/pack/mah_encode_notes.test"
+    #include "suites/pack/mah_decode_notes.test"
+    
+    #include "suites/stats/mah_stats.test"
+    
+    #include "suites/arena/mah_arena.test"
+
+    #include "suites/midi/mah_read_midi_file.test"
+    #include "suites/midi/mah_read_midi_notes.test"
+    #include "suites/midi/mah_write_midi_file.test"
+
+    #include "suites/corpus/mah_write_corpus.test"
+    #include "suites/corpus/mah_read_corpus.test"
+
+    #include "suites/timeline/mah_get_timeline.test"
+
+    #include "suites/quant/mah_get_quant_table.test"
+    #include "suites/quant/mah_quantize_notes.test"
+    
     printf("%d / %d Tests Passed", TEST.pass, TEST.total);
     if (TEST.pass != TEST.total) {
         return EXIT_FAILURE;
@@ -253,3 +309,47 @@ comp_nontertian_chord(struct mah_nontertian_chord chord_a, struct mah_nontertian
            comp_notes(chord_a.notes, chord_b.notes, chord_a.size, chord_b.size) &&
            comp_notes(chord_a.base, chord_b.base, chord_a.size, chord_b.size);
 }
+
+bool
+comp_midi_note(struct mah_midi_note note_a, struct mah_midi_note note_b)
+{
+    return comp_note(note_a.note, note_b.note) &&
+           note_a.start == note_b.start &&
+           note_a.ticks == note_b.ticks &&
+           note_a.track == note_b.track &&
+           note_a.channel == note_b.channel &&
+           note_a.velocity == note_b.velocity;
+}
+
+void
+collect_midi_notes(struct mah_midi_note const notes[], int num, void* ctx)
+{
+    struct MidiNotes* midi = ctx;
+    for (int i = 0; i < num && midi->size < 16; i++) {
+        midi->notes[midi->size++] = notes[i];
+    }
+    midi->calls++;
+}
+
+bool
+comp_timed_note(struct mah_timed_note note_a, struct mah_timed_note note_b)
+{
+    bool same_tuplet = note_a.tuplet == note_b.tuplet || (note_a.tuplet != NULL && note_b.tuplet != NULL &&
+        note_a.tuplet->n == note_b.tuplet->n && note_a.tuplet->m == note_b.tuplet->m &&
+        note_a.tuplet->base == note_b.tuplet->base);
+    return note_a.tone_timed == note_b.tone_timed &&
+           note_a.acci_timed == note_b.acci_timed &&
+           note_a.octave_timed == note_b.octave_timed &&
+           note_a.duration == note_b.duration &&
+           same_tuplet;
+}
+
+bool
+comp_tied_notes(struct mah_tied_list list, struct mah_tied_note const* notes, int size)
+{
+    bool same = list.size == size;
+    for (int i = 0; same && i < size; i++) {
+        same = comp_timed_note(list.results[i].note, notes[i].note) && list.results[i].tie == notes[i].tie;
+    }
+    return same;
+}